@@ -0,0 +1,79 @@
+#include <raster/alloc.hpp>
+
+#include <cstdlib>
+#include <new>
+
+
+#ifndef NDEBUG
+
+namespace
+{
+
+// Number of heap allocations made by each thread
+thread_local size_t num_allocs = 0;
+
+void* allocate(size_t size, size_t alignment)
+{
+    ++num_allocs;
+
+    // NOTE: `aligned_alloc` requires the size to be a multiple of the alignment
+    void* ptr = alignment <= alignof(std::max_align_t)
+                    ? std::malloc(size == 0 ? 1 : size)
+                    : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+}  // namespace
+
+
+// Replace the global allocation functions to count allocations. The array and non-throwing versions call these.
+
+void* operator new(size_t size)
+{
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+
+namespace raster::alloc
+{
+
+size_t count()
+{
+#ifndef NDEBUG
+    return num_allocs;
+#else
+    return 0;
+#endif
+}
+
+}  // namespace raster::alloc
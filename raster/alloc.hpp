@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace raster::alloc
+{
+
+/**
+ * Number of heap allocations made by the calling thread so far.
+ *
+ * Allocations are only counted in debug builds, i.e. when `NDEBUG` is not defined. Otherwise, this always returns
+ * zero.
+ */
+size_t count();
+
+}  // namespace raster::alloc
@@ -1,11 +1,15 @@
 #include <raster/app.hpp>
 
+#include <raster/alloc.hpp>
 #include <raster/colors.hpp>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <chrono>
 #include <numbers>
-#include <thread>
+
+#include <cassert>
 
 
 namespace
@@ -13,59 +17,211 @@ namespace
 
 constexpr float ANGULAR_ACCELERATION = 0.01;
 
+// Maximum number of physics ticks to simulate per frame. If rendering falls further behind than this, the simulation
+// slows down instead of trying to catch up.
+constexpr int MAX_TICKS_PER_FRAME = 8;
+
+// Number of rows and columns of the grid of views in multi-view mode
+constexpr int VIEW_GRID_SIZE = 2;
+
+/**
+ * Position of a view in multi-view mode, looking at the origin.
+ */
+struct ViewPose {
+    Eigen::Vector3f position;
+    Eigen::Vector3f world_up;
+};
+
+// Views in multi-view mode: front, side, top, and an oblique view, in row-major order of the grid
+const ViewPose VIEW_POSES[VIEW_GRID_SIZE * VIEW_GRID_SIZE] = {
+    {{2, 0, 0}, Eigen::Vector3f::UnitZ()},
+    {{0, 2, 0}, Eigen::Vector3f::UnitZ()},
+    {{0, 0, 2}, -Eigen::Vector3f::UnitX()},
+    {{1.2, 1.2, 1.2}, Eigen::Vector3f::UnitZ()},
+};
+
 std::chrono::steady_clock::time_point now()
 {
     return std::chrono::steady_clock::now();
 }
 
+/**
+ * Convert a duration to the representation of the clock, so that it can be added to time points.
+ */
+std::chrono::steady_clock::duration to_clock_duration(std::chrono::duration<double, std::milli> d)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(d);
+}
+
 }  // namespace
 
 
 namespace raster
 {
 
-App::App(int rows, int cols, double frames_per_sec)
-    : mesh_kinetics(0.99f, 0.99f),
-      camera(rows, cols, std::numbers::pi / 2),
-      frames_per_sec(frames_per_sec)
+App::App(int rows, int cols, const char* obj, double frames_per_sec, double ticks_per_sec)
+    : t_created(now()),
+      display(rows, cols),
+      camera(display.image_height(), display.image_width(), std::numbers::pi / 2),
+      loader(std::make_unique<MeshLoader>(obj)),
+      input(display.window()),
+      frames_per_sec(frames_per_sec),
+      ticks_per_sec(ticks_per_sec)
 {
-    mesh = Mesh("data/cube.obj");
+    assert(ticks_per_sec > 0);
+
+    // the mesh starts empty and is filled in by `loader`
+    cube_mesh = scene.add_mesh(Mesh());
+    cube = scene.add_instance(cube_mesh, Eigen::Affine3f::Identity(), 0.99f, 0.99f);
+
+    // light the scene from above and behind the camera
+    scene.lighting().lights.push_back(
+        {.type = Light::Type::Directional,
+         .vector = Eigen::Vector3f(-1, 0.5, -1),
+         .intensity = Eigen::Array3f::Constant(0.8f)});
 
     // set camera away from origin looking at the triangle
     camera.set_pose(Eigen::Affine3f(Eigen::Translation3f(2, 0, 0)));
     camera.look_at(Eigen::Vector3f(0, 0, 0));
 
+    // set up multi-view mode. NOTE: all cameras are updated together, so `view_camera_ptrs` stays valid
+    const int view_rows = rows / VIEW_GRID_SIZE;
+    const int view_cols = cols / VIEW_GRID_SIZE;
+    for (int i = 0; i < VIEW_GRID_SIZE * VIEW_GRID_SIZE; ++i) {
+        const Display& view_display = view_displays.emplace_back(
+            view_rows, view_cols, (i / VIEW_GRID_SIZE) * view_rows, (i % VIEW_GRID_SIZE) * view_cols);
+        Camera& view_camera = view_cameras.emplace_back(
+            view_display.image_height(), view_display.image_width(), std::numbers::pi / 2);
+        view_camera.set_pose(Eigen::Affine3f(Eigen::Translation3f(VIEW_POSES[i].position)));
+        view_camera.look_at(Eigen::Vector3f(0, 0, 0), VIEW_POSES[i].world_up);
+    }
+    for (Camera& view_camera : view_cameras) {
+        view_camera_ptrs.push_back(&view_camera);
+    }
+
     // ncurses stuff
-    init_colors();                   // initialize colors
-    curs_set(0);                     // hide cursor
-    keypad(camera.window(), true);   // allow arrow keys
-    nodelay(camera.window(), true);  // user input is non-blocking
+    init_colors();                    // initialize colors
+    curs_set(0);                      // hide cursor
+    keypad(display.window(), true);   // allow arrow keys
+    nodelay(display.window(), true);  // user input is non-blocking. NOTE: `input` sets timeouts to wait for keys
 }
 
 void App::run()
 {
+    using duration = std::chrono::duration<double, std::milli>;
+
     // How much time passes between frames
-    const std::chrono::duration<double, std::milli> frame_interval(1000.0 / frames_per_sec);
+    const duration frame_interval(frames_per_sec > 0 ? 1000.0 / frames_per_sec : 0.0);
+    // How much time passes between physics ticks
+    const duration tick_interval(1000.0 / ticks_per_sec);
+
+    const auto t_start = now();
+    auto t_prev_frame = t_start;
+    // Simulation time that has elapsed but not yet been simulated
+    duration lag = duration::zero();
 
     while (true) {
         const auto t_frame = now();
 
-        // get user key
-        const auto key = wgetch(camera.window());
-        if (!handle_keystroke(key)) {
+        // once loading is done, all buffers have been sized by earlier frames and are reused
+        const bool steady_state = !loader && _stats.frames > 0;
+        [[maybe_unused]] const size_t num_allocs = alloc::count();
+
+        lag = std::min<duration>(lag + (t_frame - t_prev_frame), tick_interval * MAX_TICKS_PER_FRAME);
+        t_prev_frame = t_frame;
+
+        // read keys that arrived while the previous frame was rendered
+        input.poll();
+
+        // advance simulation in fixed steps. each tick first applies the keys that arrived before the end of the
+        // interval that it simulates, so keys take effect in order and at the right tick
+        bool quit = false;
+        while (lag >= tick_interval) {
+            if (!apply_input(t_frame + to_clock_duration(tick_interval - lag))) {
+                quit = true;
+                break;
+            }
+            tick();
+            lag -= tick_interval;
+        }
+        if (quit) {
             break;
         }
 
-        camera.render(mesh);
+        // add any geometry that has been loaded since the last frame
+        if (loader) {
+            loader->poll(scene.mesh(cube_mesh));
+            if (loader->done() && !loader->error().empty()) {
+                _error = loader->error();
+                break;
+            }
+        }
+
+        // Eigen allocates dynamic-size matrices with `malloc()`, which `alloc::count()` does not see, so forbid its
+        // allocations directly while rendering. NOTE: this asserts as soon as Eigen allocates
+        Eigen::internal::set_is_malloc_allowed(!steady_state || views_changed);
+
+        // render in between the previous and current physics states
+        const float alpha = lag / tick_interval;
+        if (multi_view) {
+            Camera::render(scene, view_camera_ptrs, alpha);
+            for (size_t i = 0; i < view_cameras.size(); ++i) {
+                view_displays[i].present(view_cameras[i].frame());
+            }
+        } else {
+            camera.render(scene, alpha);
+            display.present(camera.frame());
+        }
+        if (exporter) {
+            exporter->publish(multi_view ? view_cameras.front().frame() : camera.frame());
+        }
+
+        // draw loading progress over the border
+        if (loader) {
+            WINDOW* window = multi_view ? view_displays.front().window() : display.window();
+            mvwprintw(window, 0, 2, " loading %3d%% ", static_cast<int>(100 * loader->progress()));
+            wnoutrefresh(window);
+            if (loader->done()) {
+                loader.reset();
+            }
+        }
+
         doupdate();
+        Eigen::internal::set_is_malloc_allowed(true);
+        const auto t_presented = now();
+        // no heap allocations in steady state, unless the buffers of the views were resized
+        assert(!steady_state || views_changed || alloc::count() == num_allocs);
+        views_changed = false;
+        if (_stats.frames++ == 0) {
+            _stats.time_to_first_frame = t_presented - t_created;
+        }
 
-        // clear input buffer to avoid keystrokes from building up
-        flushinp();
+        // the keys applied since the last frame are now on screen
+        for (size_t i = 0; i < num_applied; ++i) {
+            _stats.input_latency.add(t_presented - applied_arrivals[i]);
+        }
+        num_applied = 0;
 
-        // wait until frame ends
-        const std::chrono::duration<double, std::milli> remaining_interval = frame_interval - (now() - t_frame);
-        std::this_thread::sleep_for(max(remaining_interval, std::chrono::duration<double, std::milli>::zero()));
+        // wait until frame ends, reading keys as they arrive
+        input.wait_until(t_frame + to_clock_duration(frame_interval));
     }
+
+    _stats.elapsed = now() - t_start;
+    _stats.dropped_keys = input.dropped();
+}
+
+bool App::apply_input(InputQueue::clock::time_point time)
+{
+    InputQueue::Event event;
+    while (input.pop(time, event)) {
+        if (!handle_keystroke(event.key)) {
+            return false;
+        }
+        // NOTE: at most `InputQueue::CAPACITY` keys can be applied per frame, since the queue is only refilled between
+        // frames
+        applied_arrivals[num_applied++] = event.arrival;
+    }
+    return true;
 }
 
 bool App::handle_keystroke(int key)
@@ -94,6 +250,55 @@ bool App::handle_keystroke(int key)
             delta_ang_velocity = {0, 0, ANGULAR_ACCELERATION};
             break;
         }
+        case 'm': {  // cycle shading modes
+            Shading shading = Shading::Textured;
+            switch (camera.shading()) {
+                case Shading::Textured:
+                    shading = Shading::Lit;
+                    break;
+                case Shading::Lit:
+                    shading = Shading::Gouraud;
+                    break;
+                case Shading::Gouraud:
+                    shading = Shading::Flat;
+                    break;
+                case Shading::Flat:
+                    shading = Shading::Depth;
+                    break;
+                case Shading::Depth:
+                    shading = Shading::Textured;
+                    break;
+            }
+            camera.set_shading(shading);
+            for (Camera& view_camera : view_cameras) {
+                view_camera.set_shading(shading);
+            }
+            break;
+        }
+        case 'o': {  // toggle ordered dithering
+            const bool dither = !camera.dithering();
+            camera.set_dithering(dither);
+            for (Camera& view_camera : view_cameras) {
+                view_camera.set_dithering(dither);
+            }
+            break;
+        }
+        case 'h': {  // toggle half blocks
+            const Presentation presentation =
+                display.presentation() == Presentation::HalfBlock ? Presentation::Block : Presentation::HalfBlock;
+            display.set_presentation(presentation);
+            camera.set_resolution(display.image_height(), display.image_width());
+            for (size_t i = 0; i < view_cameras.size(); ++i) {
+                view_displays[i].set_presentation(presentation);
+                view_cameras[i].set_resolution(view_displays[i].image_height(), view_displays[i].image_width());
+            }
+            views_changed = true;
+            break;
+        }
+        case 'v':  // toggle multi-view mode
+            multi_view = !multi_view;
+            views_changed = true;
+            break;
         case 'r':  // refresh
             clearok(curscr, true);
             break;
@@ -103,11 +308,16 @@ bool App::handle_keystroke(int key)
             break;
     }
 
-    // update mesh
-    const Eigen::Affine3f delta_pose = mesh_kinetics.update(Eigen::Vector3f::Zero(), delta_ang_velocity);
-    mesh.transform(delta_pose);
+    // update velocity of the cube
+    scene.accelerate(cube, Eigen::Vector3f::Zero(), delta_ang_velocity);
 
     return true;
 }
 
+void App::tick()
+{
+    scene.tick();
+    ++_stats.ticks;
+}
+
 }  // namespace raster
@@ -1,8 +1,17 @@
 #pragma once
 
 #include <raster/camera.hpp>
-#include <raster/mesh.hpp>
-#include <raster/physics.hpp>
+#include <raster/display.hpp>
+#include <raster/exporter.hpp>
+#include <raster/input.hpp>
+#include <raster/loader.hpp>
+#include <raster/scene.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 namespace raster
@@ -11,21 +20,64 @@ namespace raster
 class App
 {
 public:
+    /**
+     * Statistics collected while the application runs.
+     */
+    struct Stats {
+        // Number of frames rendered.
+        long frames = 0;
+        // Number of physics ticks simulated.
+        long ticks = 0;
+        // Wall-clock time spent running.
+        std::chrono::duration<double> elapsed = std::chrono::duration<double>::zero();
+        // Wall-clock time from creating the application to presenting the first frame.
+        std::chrono::duration<double> time_to_first_frame = std::chrono::duration<double>::zero();
+        // Wall-clock time from reading each key to presenting the first frame that reflects it.
+        LatencyHistogram input_latency;
+        // Number of keys dropped because they arrived faster than frames could apply them.
+        long dropped_keys = 0;
+    };
+
     /**
      * Create application.
      *
      * @param rows Number of rows.
      * @param cols Number of columns.
-     * @param frames_per_sec Number of frames to render per second.
+     * @param obj Path to .obj file of the mesh to display. It is loaded in the background while the app runs.
+     * @param frames_per_sec Number of frames to render per second. If non-positive, frames are rendered as fast as
+     * possible.
+     * @param ticks_per_sec Number of physics ticks to simulate per second. Independent of the frame rate.
      */
-    App(int rows, int cols, double frames_per_sec = 30.0);
+    App(int rows, int cols, const char* obj, double frames_per_sec = 30.0, double ticks_per_sec = 30.0);
+
+    /**
+     * Export every rendered frame, e.g. to shared memory.
+     *
+     * @param exporter Exporter to publish frames to.
+     */
+    inline void export_frames(std::unique_ptr<FrameExporter> exporter) { this->exporter = std::move(exporter); }
 
     /**
      * Run the application.
      */
     void run();
 
+    inline const Stats& stats() const { return _stats; }
+
+    /**
+     * Describes why the application stopped early, e.g. because the mesh failed to load. Empty if it ran until the
+     * user quit.
+     */
+    inline const std::string& error() const { return _error; }
+
 private:
+    /**
+     * Apply the keys that arrived up to the given time, in order.
+     *
+     * @returns False when we want to quit.
+     */
+    bool apply_input(InputQueue::clock::time_point time);
+
     /**
      * Perform action associated with given keystroke.
      *
@@ -34,11 +86,46 @@ private:
      */
     bool handle_keystroke(int key);
 
-    Mesh mesh;
-    Kinetics mesh_kinetics;
+    /**
+     * Advance the simulation by one physics tick.
+     */
+    void tick();
+
+    // Time when the application was created
+    const std::chrono::steady_clock::time_point t_created;
+
+    Scene scene;
+    Display display;
     Camera camera;
 
+    // Views shown instead of `camera` in multi-view mode, laid out in a grid. Each has its own window.
+    std::vector<Display> view_displays;
+    std::vector<Camera> view_cameras;
+    // Pointers to `view_cameras`, to render them together
+    std::vector<Camera*> view_camera_ptrs;
+    bool multi_view = false;
+    // Whether the views changed since the last frame, in which case their buffers may be resized
+    bool views_changed = false;
+
+    // Index of the mesh and instance controlled by the user
+    size_t cube_mesh;
+    size_t cube;
+
+    // Loader for the mesh. Reset once loading is done.
+    std::unique_ptr<MeshLoader> loader;
+    // Exporter for rendered frames. Null if frames are not exported.
+    std::unique_ptr<FrameExporter> exporter;
+
+    InputQueue input;
+    // Arrival times of the keys applied since the last frame was presented
+    std::array<InputQueue::clock::time_point, InputQueue::CAPACITY> applied_arrivals;
+    size_t num_applied = 0;
+
     const double frames_per_sec;
+    const double ticks_per_sec;
+
+    Stats _stats;
+    std::string _error;
 };
 
 }  // namespace raster
@@ -0,0 +1,88 @@
+#include <raster/batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+namespace
+{
+
+// Number of frames in flight per thread. More than one keeps threads busy while the oldest frame is being written.
+constexpr int FRAMES_IN_FLIGHT_PER_THREAD = 4;
+
+/**
+ * A rendered frame waiting to be written.
+ */
+struct Slot {
+    // Color pair of each pixel, in row-major order
+    std::vector<uint8_t> pixels;
+    // Whether the frame has been rendered
+    std::atomic<bool> ready = false;
+};
+
+}  // namespace
+
+
+namespace raster
+{
+
+BatchRenderer::BatchRenderer(int height, int width, float horizontal_fov, int num_threads, Shading shading)
+    : pool(num_threads)
+{
+    for (int i = 0; i < num_threads; ++i) {
+        cameras.emplace_back(height, width, horizontal_fov);
+        cameras.back().set_shading(shading);
+    }
+}
+
+bool BatchRenderer::render(const Scene& scene, const std::vector<FramePoses>& frames, std::ostream& out)
+{
+    const int height = cameras.front().height();
+    const int width = cameras.front().width();
+
+    const RawHeader header = {.height = height, .width = width, .num_frames = static_cast<uint32_t>(frames.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // frame `i` is rendered into slot `i % num_slots`, once frame `i - num_slots` has been written
+    const size_t num_slots = FRAMES_IN_FLIGHT_PER_THREAD * pool.size();
+    const auto slots = std::make_unique<Slot[]>(num_slots);
+
+    const auto submit = [&](size_t frame) {
+        pool.submit([&, frame](int worker) {
+            Camera& camera = cameras[worker];
+            camera.set_pose(frames[frame].camera_to_world);
+            camera.render(scene, frames[frame].instance_poses);
+
+            Slot& slot = slots[frame % num_slots];
+            slot.pixels.resize(static_cast<size_t>(camera.height()) * camera.width());
+            camera.frame().read_color_pairs(slot.pixels.data());
+            slot.ready.store(true, std::memory_order_release);
+            slot.ready.notify_one();
+        });
+    };
+
+    for (size_t frame = 0; frame < std::min(num_slots, frames.size()); ++frame) {
+        submit(frame);
+    }
+
+    // write frames in order. NOTE: after a write fails, the remaining frames are still waited for, since they refer to
+    // local variables
+    for (size_t frame = 0; frame < frames.size(); ++frame) {
+        Slot& slot = slots[frame % num_slots];
+        slot.ready.wait(false, std::memory_order_acquire);
+        if (out) {
+            out.write(reinterpret_cast<const char*>(slot.pixels.data()), slot.pixels.size());
+        }
+        slot.ready.store(false, std::memory_order_relaxed);
+
+        if (frame + num_slots < frames.size()) {
+            submit(frame + num_slots);
+        }
+    }
+
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+}  // namespace raster
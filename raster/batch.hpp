@@ -0,0 +1,81 @@
+#pragma once
+
+#include <raster/camera.hpp>
+#include <raster/pool.hpp>
+#include <raster/scene.hpp>
+#include <raster/shading.hpp>
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * Poses of the camera and of the instances of a scene in one frame.
+ */
+struct FramePoses {
+    Eigen::Affine3f camera_to_world;
+    // Pose of each instance of the scene
+    std::vector<Eigen::Affine3f> instance_poses;
+};
+
+/**
+ * Header of the raw frames written by `BatchRenderer`. Integers are in the native byte order.
+ *
+ * The header is followed by the frames. Each frame is `height * width` bytes in row-major order, one color pair per
+ * pixel. A color pair of zero means that nothing was drawn; otherwise, the color pair minus one is the color encoding
+ * described in `init_colors()`.
+ */
+struct RawHeader {
+    char magic[4] = {'R', 'S', 'T', 'F'};
+    uint32_t version = 1;
+    int32_t height;
+    int32_t width;
+    uint32_t num_frames;
+};
+
+/**
+ * Renders sequences of frames offline, e.g. for regression captures and previews.
+ *
+ * Frames do not depend on each other once the poses are known, so they are rendered concurrently by a thread pool, with
+ * a camera per worker. Finished frames are written in order. Only a few frames are in flight at once, so memory use
+ * does not depend on the number of frames.
+ */
+class BatchRenderer
+{
+public:
+    /**
+     * Create renderer.
+     *
+     * @param height Image height, in pixels.
+     * @param width Image width, in pixels.
+     * @param horizontal_fov Horizontal field of view, in radians.
+     * @param num_threads Number of threads to render with.
+     * @param shading How faces are shaded.
+     */
+    BatchRenderer(int height, int width, float horizontal_fov, int num_threads, Shading shading = Shading::Textured);
+
+    /**
+     * Render frames of a scene and write them in the raw format described by `RawHeader`.
+     *
+     * @param scene Scene to render. Instance poses are taken from `frames`.
+     * @param frames Poses of each frame.
+     * @param out Stream to write to, opened in binary mode.
+     * @returns False if writing failed.
+     */
+    bool render(const Scene& scene, const std::vector<FramePoses>& frames, std::ostream& out);
+
+private:
+    // Camera of each worker of `pool`
+    std::vector<Camera> cameras;
+
+    // NOTE: declared last so that the workers stop before the cameras are destroyed
+    ThreadPool pool;
+};
+
+}  // namespace raster
@@ -3,7 +3,9 @@
 #include <raster/colors.hpp>
 
 #include <algorithm>
+#include <limits>
 
+#include <cassert>
 #include <cmath>
 
 
@@ -115,75 +117,173 @@ namespace raster
 {
 
 Camera::Camera(int height, int width, float horizontal_fov, const Eigen::Affine3f& pose)
-    : _window(newwin(height, width, 0, 0)),
-      intrinsics(
-          {.width = width,
-           .height = height,
-           .cx = width / 2.f - 0.5f,
-           .cy = height / 2.f - 0.5f,
-           .fx = (width / 2.f) * std::tan(horizontal_fov / 2.f),
-           .fy = (height / 2.f) * std::tan(horizontal_fov / 2.f)}),
+    : horizontal_fov(horizontal_fov),
+      intrinsics(make_intrinsics(height, width, horizontal_fov)),
       camera_to_world(pose),
       world_to_camera(pose.inverse())
 {
 }
 
-Camera::Camera(Camera&& other)
-    : _window(other._window),
-      intrinsics(std::move(other.intrinsics)),
-      camera_to_world(std::move(other.camera_to_world)),
-      world_to_camera(std::move(other.world_to_camera))
+void Camera::render(const Scene& scene, float alpha)
 {
-    other._window = nullptr;
+    Camera* const cameras[] = {this};
+    render_with(scene, cameras, [&](size_t instance) { return scene.pose(instance, alpha); });
 }
 
-Camera& Camera::operator=(Camera&& other)
+void Camera::render(const Scene& scene, const std::vector<Eigen::Affine3f>& poses)
 {
-    _window = other._window;
-    other._window = nullptr;
-    intrinsics = std::move(other.intrinsics);
-    camera_to_world = std::move(other.camera_to_world);
-    world_to_camera = std::move(other.world_to_camera);
-    return *this;
+    assert(poses.size() == scene.num_instances());
+    Camera* const cameras[] = {this};
+    render_with(scene, cameras, [&](size_t instance) { return poses[instance]; });
 }
 
-void Camera::render(const Mesh& mesh) const
+void Camera::render(const Scene& scene, std::span<Camera* const> cameras, float alpha)
 {
-    werase(_window);
+    render_with(scene, cameras, [&](size_t instance) { return scene.pose(instance, alpha); });
+}
+
+template <typename Pose>
+void Camera::render_with(const Scene& scene, std::span<Camera* const> cameras, Pose pose)
+{
+    assert(!cameras.empty());
+    const Shading shading = cameras.front()->_shading;
+    VertexArena& vertex_arena = cameras.front()->vertex_arena;
+
+    // initialize buffers. they are only reallocated if the image size changed
+    for (Camera* camera : cameras) {
+        assert(camera->_shading == shading);
+        camera->arena.resize(camera->intrinsics.height, camera->intrinsics.width);
+        camera->arena.clear();
+    }
+
+    // with several cameras, transform the vertices to world space once and share them. a single camera transforms
+    // them straight to camera space instead, which saves a pass over the vertices
+    const bool share_world_vertices = cameras.size() > 1;
+
+    // draw all instances of a mesh together, so that the mesh data stays in cache
+    for (size_t mesh = 0; mesh < scene.num_meshes(); ++mesh) {
+        for (const size_t instance : scene.instances(mesh)) {
+            const Eigen::Affine3f model_to_world = pose(instance);
+            transform_vertices(
+                scene.mesh(mesh), model_to_world, scene.lighting(), shading, share_world_vertices, vertex_arena);
+            for (Camera* camera : cameras) {
+                if (share_world_vertices) {
+                    camera->draw(
+                        scene.mesh(mesh), vertex_arena.world_vertices, Eigen::Affine3f::Identity(), vertex_arena);
+                } else {
+                    camera->draw(scene.mesh(mesh), scene.mesh(mesh).vertices(), model_to_world, vertex_arena);
+                }
+            }
+        }
+    }
+
+    if (shading == Shading::Depth) {
+        for (Camera* camera : cameras) {
+            camera->shade_depth();
+        }
+    }
+}
+
+void Camera::transform_vertices(
+    const Mesh& mesh,
+    const Eigen::Affine3f& model_to_world,
+    const Lighting& lighting,
+    Shading shading,
+    bool world_vertices,
+    VertexArena& vertex_arena)
+{
+    const auto& vertices = mesh.vertices();
+    const auto& vertex_colors = mesh.vertex_colors();
+    vertex_arena.resize(vertices.size());
+
+    // transform each vertex once, rather than once per face that it belongs to
+    if (world_vertices) {
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertex_arena.world_vertices[i] = model_to_world * vertices[i];
+        }
+    }
+
+    // vertex colors are not needed for depth-only passes
+    if (shading != Shading::Depth) {
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertex_arena.linear_colors[i] = srgb_to_linear(vertex_colors[i]);
+        }
+    }
+
+    // evaluate lights once per vertex, rather than once per pixel
+    if (shading == Shading::Lit) {
+        light_vertices(lighting, model_to_world, vertices, mesh.vertex_normals(), vertex_arena.linear_colors);
+    }
+}
 
-    // draw border
-    box(_window, 0, 0);
+void Camera::draw(
+    const Mesh& mesh,
+    const std::vector<Eigen::Vector3f>& vertices,
+    const Eigen::Affine3f& to_world,
+    const VertexArena& vertex_arena)
+{
+    arena.resize_vertices(vertices.size());
+
+    // compose the transformations once, rather than applying them one after the other to each vertex
+    const Eigen::Affine3f to_camera = world_to_camera * to_world;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Eigen::Vector3f v = to_camera * vertices[i];
+        arena.camera_vertices[i] = v;
+
+        // project to image plane and convert to pixel coords. points behind the camera are skipped later
+        Eigen::Vector2f p;
+        if (project_point(v, p)) {
+            arena.pixel_vertices[i] = image_plane_to_pixel(p, intrinsics);
+        }
+    }
 
-    // initialize z-buffer
-    Eigen::ArrayXXf z_buf = Eigen::ArrayXXf::Constant(intrinsics.height, intrinsics.width, -1.0);
+    // choose the shader once for the whole mesh
+    const Shading shading = _shading == Shading::Textured && !mesh.has_texture() ? Shading::Gouraud : _shading;
+    switch (shading) {
+        case Shading::Depth:
+            rasterize<shading::Depth>(mesh, vertex_arena);
+            break;
+        case Shading::Flat:
+            rasterize<shading::Flat>(mesh, vertex_arena);
+            break;
+        case Shading::Gouraud:
+        case Shading::Lit:
+            rasterize<shading::Gouraud>(mesh, vertex_arena);
+            break;
+        case Shading::Textured:
+            rasterize<shading::Textured>(mesh, vertex_arena);
+            break;
+    }
+}
 
-    for (auto ptr = mesh.begin(); ptr != mesh.end(); ++ptr) {
-        const auto& face = *ptr;
+template <typename Shader>
+void Camera::rasterize(const Mesh& mesh, const VertexArena& vertex_arena)
+{
+    const auto& face_vertex_indices = mesh.face_vertex_indices();
+    for (size_t face = 0; face < face_vertex_indices.size(); ++face) {
+        const Eigen::Array3i& indices = face_vertex_indices[face];
 
         // get triangle points in camera space
-        const Eigen::Vector3f v1 = world_to_camera * face.v1;
-        const Eigen::Vector3f v2 = world_to_camera * face.v2;
-        const Eigen::Vector3f v3 = world_to_camera * face.v3;
-
-        // project triangle points to image plane
-        Eigen::Vector2f p1, p2, p3;
-        if (!project_point(v1, p1) || !project_point(v2, p2) || !project_point(v3, p3)) {
-            // skip if a portion of the triangle lies outside of the image plane
+        const Eigen::Vector3f& v1 = arena.camera_vertices[indices(0)];
+        const Eigen::Vector3f& v2 = arena.camera_vertices[indices(1)];
+        const Eigen::Vector3f& v3 = arena.camera_vertices[indices(2)];
+
+        if (v1.z() < FrameArena::DEPTH_NEAR || v2.z() < FrameArena::DEPTH_NEAR || v3.z() < FrameArena::DEPTH_NEAR) {
+            // skip if a portion of the triangle lies in front of the near plane. this includes triangles that lie
+            // partly outside of the image plane, and triangles so close that their packed depths would all tie
             continue;
         }
 
-        // convert from image plane coords to pixel coords
-        const Eigen::Vector2f pix1 = image_plane_to_pixel(p1, intrinsics);
-        const Eigen::Vector2f pix2 = image_plane_to_pixel(p2, intrinsics);
-        const Eigen::Vector2f pix3 = image_plane_to_pixel(p3, intrinsics);
+        // get triangle points in pixel coords
+        const Eigen::Vector2f& pix1 = arena.pixel_vertices[indices(0)];
+        const Eigen::Vector2f& pix2 = arena.pixel_vertices[indices(1)];
+        const Eigen::Vector2f& pix3 = arena.pixel_vertices[indices(2)];
 
         // get bounding box
         const BoundingBox bbox = get_bounding_box(pix1, pix2, pix3, intrinsics.height, intrinsics.width);
 
-        // divide vertex colors by z-coordinate
-        const Eigen::Array3f corrected_c1 = srgb_to_linear(face.c1) / v1.z();
-        const Eigen::Array3f corrected_c2 = srgb_to_linear(face.c2) / v2.z();
-        const Eigen::Array3f corrected_c3 = srgb_to_linear(face.c3) / v3.z();
+        // set up shader for the face
+        const Shader shader(arena, vertex_arena, mesh, face, {v1.z(), v2.z(), v3.z()});
 
         // rasterize mesh face
         for (int row = bbox.min_row; row <= bbox.max_row; ++row) {
@@ -197,31 +297,62 @@ void Camera::render(const Mesh& mesh) const
                     continue;
                 }
 
-                // compute z for the pixel using perspective-correct interpolation
-                const float& prev_z = z_buf(row, col);
-                const float z = 1 / (b1 / v1.z() + b2 / v2.z() + b3 / v3.z());
-                if (prev_z > 0 && z >= prev_z) {
+                // the reciprocal of z is linear in screen space, so the depth test does not need a division. larger
+                // packed depths are closer
+                const float inv_z = b1 / v1.z() + b2 / v2.z() + b3 / v3.z();
+                const uint16_t depth = FrameArena::pack_depth(inv_z);
+                const size_t idx = arena.index(row, col);
+                if (depth <= arena.depth[idx]) {
                     continue;
                 }
 
-                // update z-buffer and render pixel
-                z_buf(row, col) = z;
+                // update z-buffer
+                arena.depth[idx] = depth;
+
+                // compute color for the pixel, with z from perspective-correct interpolation
+                if constexpr (Shader::writes_color) {
+                    arena.color_pairs[idx] = quantizer(shader(b1, b2, b3, 1 / inv_z), row, col);
+                }
+            }
+        }
+    }
+}
+
+void Camera::shade_depth()
+{
+    // find the nearest and farthest pixels. NOTE: larger packed depths are closer, and zero means nothing was drawn
+    uint16_t nearest = 0;
+    uint16_t farthest = std::numeric_limits<uint16_t>::max();
+    for (const uint16_t depth : arena.depth) {
+        if (depth != 0) {
+            nearest = std::max(nearest, depth);
+            farthest = std::min(farthest, depth);
+        }
+    }
+    if (nearest == 0) {
+        return;
+    }
 
-                // compute color for the pixel using perspective-correct interpolation
-                const Eigen::Array3f c =
-                    linear_to_srgb(z * (corrected_c1 * b1 + corrected_c2 * b2 + corrected_c3 * b3));
-                const short color_pair = rgb_to_color_pair(c);
+    // map nearest pixels to white and farthest pixels to dark gray
+    const float min_z = FrameArena::unpack_depth(nearest);
+    const float max_z = FrameArena::unpack_depth(farthest);
+    const float scale = max_z > min_z ? 0.8f / (max_z - min_z) : 0.f;
 
-                // draw pixel
-                const chtype attr = COLOR_PAIR(color_pair);
-                wattron(_window, attr);
-                mvwaddch(_window, row, col, ' ');
-                wattroff(_window, attr);
+    for (int row = 0; row < intrinsics.height; ++row) {
+        for (int col = 0; col < intrinsics.width; ++col) {
+            const size_t idx = arena.index(row, col);
+            if (arena.depth[idx] == 0) {
+                continue;
             }
+            const float brightness = 1.f - scale * (FrameArena::unpack_depth(arena.depth[idx]) - min_z);
+            arena.color_pairs[idx] = quantizer(Eigen::Array3f::Constant(brightness), row, col);
         }
     }
+}
 
-    wnoutrefresh(_window);
+void Camera::set_resolution(int height, int width)
+{
+    intrinsics = make_intrinsics(height, width, horizontal_fov);
 }
 
 void Camera::transform(const Eigen::Affine3f& t)
@@ -261,6 +392,18 @@ void Camera::set_pose(const Eigen::Affine3f& camera_to_world)
     this->world_to_camera = camera_to_world.inverse();
 }
 
+Camera::Intrinsics Camera::make_intrinsics(int height, int width, float horizontal_fov)
+{
+    return {
+        .width = width,
+        .height = height,
+        .cx = width / 2.f - 0.5f,
+        .cy = height / 2.f - 0.5f,
+        .fx = (width / 2.f) * std::tan(horizontal_fov / 2.f),
+        .fy = (height / 2.f) * std::tan(horizontal_fov / 2.f),
+    };
+}
+
 Eigen::Vector2f Camera::image_plane_to_pixel(const Eigen::Vector2f& p, const Intrinsics& intrinsics)
 {
     return {intrinsics.fx * p.x() + intrinsics.cx, intrinsics.fy * p.y() + intrinsics.cy};
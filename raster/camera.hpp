@@ -1,10 +1,16 @@
 #pragma once
 
+#include <raster/colors.hpp>
+#include <raster/frame.hpp>
 #include <raster/mesh.hpp>
+#include <raster/scene.hpp>
+#include <raster/shading.hpp>
 
-#include <ncurses.h>
 #include <Eigen/Dense>
 
+#include <span>
+#include <vector>
+
 
 namespace raster
 {
@@ -19,6 +25,11 @@ namespace raster
  *
  * A pose consists of a rotation `rot` and translation `trans`. The camera-to-world pose is implemented as an affine
  * transformation on 3D vectors. Explicitly, it is `rot * v + trans` where `v` is a vector.
+ *
+ * Frames are rendered into buffers owned by the camera, see `frame()`. They are drawn to the terminal by a `Display`.
+ *
+ * The camera has a near plane at `z = FrameArena::DEPTH_NEAR`, in camera coordinates. Faces with a vertex in front of
+ * it are not drawn, since the frame buffers cannot tell their depths apart.
  */
 class Camera
 {
@@ -41,13 +52,37 @@ public:
     Camera(const Camera&) = delete;
     Camera& operator=(const Camera&) = delete;
 
-    Camera(Camera&& other);
-    Camera& operator=(Camera&& other);
+    Camera(Camera&& other) = default;
+    Camera& operator=(Camera&& other) = default;
 
     /**
-     * Render the scene.
+     * Render the scene. Instances are drawn in batches, one mesh at a time.
+     *
+     * @param scene Scene to render.
+     * @param alpha Interpolation parameter in [0, 1] between the poses at the previous and current physics ticks.
      */
-    void render(const Mesh& mesh) const;
+    void render(const Scene& scene, float alpha = 1.f);
+
+    /**
+     * Render the scene with the given poses for its instances, rather than the poses of the scene itself. This allows
+     * rendering several states of the same scene at once.
+     *
+     * @param scene Scene to render.
+     * @param poses Pose of each instance of the scene.
+     */
+    void render(const Scene& scene, const std::vector<Eigen::Affine3f>& poses);
+
+    /**
+     * Render the scene from several cameras at once, e.g. for split screen views. The vertex work in world space, i.e.
+     * transforming vertices to world coordinates and computing their colors and lighting, is done once per instance and
+     * shared by all cameras. Each camera only transforms the vertices to its own coordinates, projects them, and
+     * rasterizes the faces.
+     *
+     * @param scene Scene to render.
+     * @param cameras Cameras to render with. They must all use the same shading.
+     * @param alpha Interpolation parameter in [0, 1] between the poses at the previous and current physics ticks.
+     */
+    static void render(const Scene& scene, std::span<Camera* const> cameras, float alpha = 1.f);
 
     /**
      * Apply an affine (i.e. rigid) transformation to the camera, with respect to the world coordinates. Concretely,
@@ -70,7 +105,47 @@ public:
      */
     void set_pose(const Eigen::Affine3f& camera_to_world);
 
-    inline WINDOW* window() const { return _window; }
+    /**
+     * Set how faces are shaded.
+     */
+    inline void set_shading(Shading shading) { _shading = shading; }
+
+    inline Shading shading() const { return _shading; }
+
+    /**
+     * Camera-to-world pose.
+     */
+    inline const Eigen::Affine3f& pose() const { return camera_to_world; }
+
+    /**
+     * Image height, in pixels.
+     */
+    inline int height() const { return intrinsics.height; }
+
+    /**
+     * Image width, in pixels.
+     */
+    inline int width() const { return intrinsics.width; }
+
+    /**
+     * Set the image size. The field of view is unchanged.
+     *
+     * @param height Image height, in pixels.
+     * @param width Image width, in pixels.
+     */
+    void set_resolution(int height, int width);
+
+    /**
+     * Set whether colors are quantized with ordered dithering.
+     */
+    inline void set_dithering(bool dither) { quantizer = ColorQuantizer(dither); }
+
+    inline bool dithering() const { return quantizer.dither(); }
+
+    /**
+     * Buffers of the most recently rendered frame.
+     */
+    inline const FrameArena& frame() const { return arena; }
 
 private:
     struct Intrinsics {
@@ -82,16 +157,85 @@ private:
         float fy;
     };
 
+    /**
+     * Render the scene from several cameras. The world space vertex buffers of the first camera are shared by all.
+     *
+     * @param pose Function that returns the pose of an instance, given its index.
+     */
+    template <typename Pose>
+    static void render_with(const Scene& scene, std::span<Camera* const> cameras, Pose pose);
+
+    /**
+     * Do the vertex work of a mesh that does not depend on the camera.
+     *
+     * @param[in] mesh Mesh to draw.
+     * @param[in] model_to_world Pose of the mesh, i.e. the transformation from mesh coordinates to world coordinates.
+     * @param[in] lighting Lights of the scene.
+     * @param[in] shading How faces are shaded.
+     * @param[in] world_vertices Whether to transform the vertices to world space. Only needed when several cameras
+     * share them.
+     * @param[out] vertex_arena Buffers to fill in.
+     */
+    static void transform_vertices(
+        const Mesh& mesh,
+        const Eigen::Affine3f& model_to_world,
+        const Lighting& lighting,
+        Shading shading,
+        bool world_vertices,
+        VertexArena& vertex_arena);
+
+    /**
+     * Draw a mesh into the frame buffers.
+     *
+     * @param mesh Mesh to draw.
+     * @param vertices Vertices of the mesh, either in mesh coordinates or in world coordinates.
+     * @param to_world Transformation from the coordinates of `vertices` to world coordinates.
+     * @param vertex_arena Vertex buffers, filled in for `mesh` by `transform_vertices()`.
+     */
+    void draw(
+        const Mesh& mesh,
+        const std::vector<Eigen::Vector3f>& vertices,
+        const Eigen::Affine3f& to_world,
+        const VertexArena& vertex_arena);
+
+    /**
+     * Rasterize the faces of a mesh into the frame buffers. Requires the vertex buffers to be filled in.
+     *
+     * @tparam Shader Shader from `raster::shading` that computes the color of each pixel.
+     */
+    template <typename Shader>
+    void rasterize(const Mesh& mesh, const VertexArena& vertex_arena);
+
+    /**
+     * Color pixels by their depth, for depth-only passes.
+     */
+    void shade_depth();
+
+    /**
+     * Compute the intrinsics for an image size.
+     *
+     * @param height Image height, in pixels.
+     * @param width Image width, in pixels.
+     * @param horizontal_fov Horizontal field of view, in radians.
+     */
+    static Intrinsics make_intrinsics(int height, int width, float horizontal_fov);
+
     /**
      * Convert a 2D point in the image plane coordinates to pixel coordinates.
      */
     static Eigen::Vector2f image_plane_to_pixel(const Eigen::Vector2f& p, const Intrinsics& intrinsics);
 
-    WINDOW* _window;
-
+    float horizontal_fov;
     Intrinsics intrinsics;
     Eigen::Affine3f camera_to_world;
     Eigen::Affine3f world_to_camera;
+
+    Shading _shading = Shading::Textured;
+    ColorQuantizer quantizer;
+
+    // Buffers reused across frames
+    FrameArena arena;
+    VertexArena vertex_arena;
 };
 
 }  // namespace raster
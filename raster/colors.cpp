@@ -3,6 +3,10 @@
 #include <ncurses.h>
 
 #include <algorithm>
+#include <iterator>
+
+#include <cassert>
+#include <cmath>
 
 
 namespace
@@ -10,6 +14,8 @@ namespace
 
 // Number of color levels
 constexpr int NUM_LEVELS = 6;
+// Number of colors
+constexpr int NUM_COLORS = NUM_LEVELS * NUM_LEVELS * NUM_LEVELS;
 // Color levels. We do not use equally-spaced levels; we follow a sqrt distribution so that we have more colors with
 // high brightness.
 constexpr std::array<short, NUM_LEVELS> LEVELS = {0, 447, 632, 775, 894, 1000};
@@ -19,6 +25,15 @@ constexpr short COLOR_ENCODING_OFFSET = 8;
 // Offset to avoid overwriting ncurses default color pair
 constexpr short PAIR_ENCODING_OFFSET = 1;
 
+// NOTE: frame buffers and quantization tables store the color pairs from `init_colors()` in 8 bits
+static_assert(NUM_COLORS + PAIR_ENCODING_OFFSET <= 256);
+
+// First color pair defined by `ColorPairCache`, after the color pairs defined by `init_colors()`
+constexpr int CACHED_PAIR_OFFSET = NUM_COLORS + PAIR_ENCODING_OFFSET;
+
+// Bayer matrix for ordered dithering
+constexpr int BAYER[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
 /**
  * Convert color value in [0, 1] to the corresponding level, i.e. index of `LEVELS`.
  */
@@ -28,6 +43,16 @@ int color_to_level(float color)
     return std::clamp(static_cast<int>(std::floor(color * color * NUM_LEVELS)), 0, NUM_LEVELS - 1);
 }
 
+/**
+ * Convert color value in [0, 1] to the corresponding level, i.e. index of `LEVELS`, with a rounding threshold in
+ * [0, 1). Averaged over all thresholds, the squared color value of the levels matches the squared color value.
+ */
+int color_to_dithered_level(float color, float threshold)
+{
+    // NOTE: the squared color values of the levels are equally spaced
+    return std::clamp(static_cast<int>(std::floor(color * color * (NUM_LEVELS - 1) + threshold)), 0, NUM_LEVELS - 1);
+}
+
 /**
  * Convert a single sRGB value to linear.
  */
@@ -74,14 +99,68 @@ void init_colors()
             }
         }
     }
+
+    // ncurses grows its table of color pairs as they are defined. reserve room for the pairs of `ColorPairCache` now,
+    // by defining the last one, so that defining them later does not allocate memory
+    const int last_cached_pair = std::min(COLOR_PAIRS, CACHED_PAIR_OFFSET + NUM_COLORS * NUM_COLORS) - 1;
+    if (last_cached_pair >= CACHED_PAIR_OFFSET) {
+        init_extended_pair(last_cached_pair, COLOR_ENCODING_OFFSET, COLOR_ENCODING_OFFSET);
+    }
 }
 
-short rgb_to_color_pair(const Eigen::Array3f& color)
+uint8_t rgb_to_color_pair(const Eigen::Array3f& color)
 {
     const int r = color_to_level(color(0));
     const int g = color_to_level(color(1));
     const int b = color_to_level(color(2));
-    return (r * NUM_LEVELS + g) * NUM_LEVELS + b + PAIR_ENCODING_OFFSET;
+    return static_cast<uint8_t>((r * NUM_LEVELS + g) * NUM_LEVELS + b + PAIR_ENCODING_OFFSET);
+}
+
+ColorPairCache::ColorPairCache() : pairs(NUM_COLORS * NUM_COLORS, 0), next_pair(CACHED_PAIR_OFFSET) {}
+
+int ColorPairCache::operator()(short fg, short bg)
+{
+    const int fg_encoding = fg - PAIR_ENCODING_OFFSET;
+    const int bg_encoding = bg - PAIR_ENCODING_OFFSET;
+    assert(0 <= fg_encoding && fg_encoding < NUM_COLORS);
+    assert(0 <= bg_encoding && bg_encoding < NUM_COLORS);
+
+    int& pair = pairs[fg_encoding * NUM_COLORS + bg_encoding];
+    if (pair == 0) {
+        if (next_pair >= COLOR_PAIRS) {
+            return fg;
+        }
+        pair = next_pair++;
+        init_extended_pair(pair, fg_encoding + COLOR_ENCODING_OFFSET, bg_encoding + COLOR_ENCODING_OFFSET);
+    }
+    return pair;
+}
+
+ColorQuantizer::ColorQuantizer(bool dither) : _dither(dither)
+{
+    static_assert(BAYER_SIZE == std::size(BAYER));
+
+    // how much a level of each channel contributes to the color pair. see `rgb_to_color_pair()`
+    constexpr int channel_weights[3] = {NUM_LEVELS * NUM_LEVELS, NUM_LEVELS, 1};
+
+    for (int row = 0; row < BAYER_SIZE; ++row) {
+        for (int col = 0; col < BAYER_SIZE; ++col) {
+            auto& table = tables[row * BAYER_SIZE + col];
+            const float threshold = (BAYER[row][col] + 0.5f) / (BAYER_SIZE * BAYER_SIZE);
+
+            for (int value = 0; value < NUM_VALUES; ++value) {
+                const float color = static_cast<float>(value) / (NUM_VALUES - 1);
+                const int level = dither ? color_to_dithered_level(color, threshold) : color_to_level(color);
+                for (int channel = 0; channel < 3; ++channel) {
+                    table[channel][value] = level * channel_weights[channel];
+                }
+            }
+            // add offset once, to the first channel
+            for (auto& contribution : table[0]) {
+                contribution += PAIR_ENCODING_OFFSET;
+            }
+        }
+    }
 }
 
 Eigen::Array3f srgb_to_linear(const Eigen::Array3f& srgb)
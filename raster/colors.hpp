@@ -2,6 +2,11 @@
 
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
 
 namespace raster
 {
@@ -16,9 +21,95 @@ namespace raster
 void init_colors();
 
 /**
- * Convert RGB value normalized to [0, 1] to the closest ncurses color pair.
+ * Convert RGB value normalized to [0, 1] to the closest ncurses color pair. The color pairs from `init_colors()` fit in
+ * 8 bits, so that frame buffers can store them compactly.
+ */
+uint8_t rgb_to_color_pair(const Eigen::Array3f& color);
+
+/**
+ * Defines ncurses color pairs with different foreground and background colors on demand.
+ *
+ * The color pairs from `init_colors()` use the same color for the foreground and background. Pairing every color with
+ * every other color would need more pairs than most terminals have, so a pair is only defined the first time it is
+ * requested, and then reused.
  */
-short rgb_to_color_pair(const Eigen::Array3f& color);
+class ColorPairCache
+{
+public:
+    ColorPairCache();
+
+    /**
+     * Get the color pair that combines the colors of two color pairs from `init_colors()`.
+     *
+     * @param fg Color pair whose color is used for the foreground.
+     * @param bg Color pair whose color is used for the background.
+     * @returns Color pair. If the terminal has run out of color pairs, this is `fg`.
+     */
+    int operator()(short fg, short bg);
+
+private:
+    // Color pair for each combination of foreground and background colors. Zero if not defined yet.
+    std::vector<int> pairs;
+    // Next color pair to define
+    int next_pair;
+};
+
+/**
+ * Quantizes RGB values to ncurses color pairs using a precomputed lookup table.
+ *
+ * With ordered dithering, the threshold for rounding each channel to a level depends on the position of the pixel,
+ * following a Bayer matrix. Gradients then show a fine, fixed pattern instead of bands. Since the pattern only depends
+ * on the position, each pixel is still quantized independently. The thresholds are folded into the table, so
+ * quantizing a pixel costs three table lookups whether or not dithering is used.
+ */
+class ColorQuantizer
+{
+public:
+    /**
+     * Create quantizer.
+     *
+     * @param dither Whether to use ordered dithering. Otherwise, this matches `rgb_to_color_pair()` up to rounding
+     * channel values to 8 bits.
+     */
+    ColorQuantizer(bool dither = false);
+
+    /**
+     * Convert RGB value normalized to [0, 1] to an ncurses color pair.
+     *
+     * @param color RGB value.
+     * @param row Row of the pixel.
+     * @param col Column of the pixel.
+     */
+    inline uint8_t operator()(const Eigen::Array3f& color, int row, int col) const
+    {
+        const auto& table = tables[(row % BAYER_SIZE) * BAYER_SIZE + col % BAYER_SIZE];
+        // NOTE: the sum is a color pair from `init_colors()`, which fits in 8 bits
+        return static_cast<uint8_t>(
+            table[0][to_index(color(0))] + table[1][to_index(color(1))] + table[2][to_index(color(2))]);
+    }
+
+    inline bool dither() const { return _dither; }
+
+private:
+    // Size of the Bayer matrix
+    static constexpr int BAYER_SIZE = 4;
+    // Number of distinct values of a channel in the table
+    static constexpr int NUM_VALUES = 256;
+
+    /**
+     * Convert a channel value in [0, 1] to an index of the table.
+     */
+    static inline int to_index(float value)
+    {
+        return std::clamp(static_cast<int>(value * (NUM_VALUES - 1) + 0.5f), 0, NUM_VALUES - 1);
+    }
+
+    bool _dither;
+
+    // For each position in the Bayer matrix, each channel, and each value, the contribution to the color pair. The
+    // color pair is the sum of the contributions of the three channels.
+    std::array<std::array<std::array<uint8_t, NUM_VALUES>, 3>, BAYER_SIZE * BAYER_SIZE> tables;
+};
 
 /**
  * Convert from sRGB color space to linear color space.
@@ -0,0 +1,115 @@
+#include <raster/display.hpp>
+
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+
+// Upper half block glyph, i.e. "▀"
+constexpr wchar_t UPPER_HALF_BLOCK[] = L"\u2580";
+
+}  // namespace
+
+
+namespace raster
+{
+
+Display::Display(int rows, int cols, int begin_row, int begin_col) : _window(newwin(rows, cols, begin_row, begin_col))
+{
+}
+
+Display::Display(Display&& other)
+    : _window(std::exchange(other._window, nullptr)),
+      _presentation(other._presentation),
+      pair_cache(std::move(other.pair_cache))
+{
+}
+
+Display& Display::operator=(Display&& other)
+{
+    if (_window) {
+        delwin(_window);
+    }
+    _window = std::exchange(other._window, nullptr);
+    _presentation = other._presentation;
+    pair_cache = std::move(other.pair_cache);
+    return *this;
+}
+
+Display::~Display()
+{
+    if (_window) {
+        delwin(_window);
+    }
+}
+
+void Display::present(const FrameArena& frame)
+{
+    werase(_window);
+
+    // draw border
+    box(_window, 0, 0);
+
+    if (_presentation == Presentation::HalfBlock) {
+        present_half_blocks(frame);
+        return;
+    }
+
+    // draw pixels
+    const int rows = std::min(frame.height, getmaxy(_window));
+    const int cols = std::min(frame.width, getmaxx(_window));
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const short color_pair = frame.color_pairs[frame.index(row, col)];
+            if (color_pair == 0) {
+                continue;
+            }
+
+            const chtype attr = COLOR_PAIR(color_pair);
+            wattron(_window, attr);
+            mvwaddch(_window, row, col, ' ');
+            wattroff(_window, attr);
+        }
+    }
+
+    wnoutrefresh(_window);
+}
+
+void Display::present_half_blocks(const FrameArena& frame)
+{
+    // empty pixels are drawn black when the other pixel of the cell is not empty
+    const short black = rgb_to_color_pair(Eigen::Array3f::Zero());
+
+    const int rows = std::min(frame.height / 2, getmaxy(_window));
+    const int cols = std::min(frame.width, getmaxx(_window));
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const short top = frame.color_pairs[frame.index(2 * row, col)];
+            const short bottom = frame.color_pairs[frame.index(2 * row + 1, col)];
+            if (top == 0 && bottom == 0) {
+                continue;
+            }
+
+            // a space takes fewer bytes to output than a half block, so use one if both pixels have the same color
+            if (top == bottom) {
+                const chtype attr = COLOR_PAIR(top);
+                wattron(_window, attr);
+                mvwaddch(_window, row, col, ' ');
+                wattroff(_window, attr);
+                continue;
+            }
+
+            // NOTE: the color pair is passed through the options argument, since it may not fit in a short
+            int color_pair = pair_cache(top != 0 ? top : black, bottom != 0 ? bottom : black);
+            cchar_t cell;
+            setcchar(&cell, UPPER_HALF_BLOCK, A_NORMAL, 0, &color_pair);
+            mvwadd_wch(_window, row, col, &cell);
+        }
+    }
+
+    wnoutrefresh(_window);
+}
+
+}  // namespace raster
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <raster/colors.hpp>
+#include <raster/frame.hpp>
+
+#include <ncurses.h>
+
+
+namespace raster
+{
+
+/**
+ * How pixels are drawn to the terminal.
+ */
+enum class Presentation {
+    // One pixel per cell, drawn as a colored space
+    Block,
+    // Two pixels per cell, stacked vertically. The cell is drawn as an upper half block, with the top pixel as the
+    // foreground color and the bottom pixel as the background color. This doubles the vertical resolution.
+    HalfBlock,
+};
+
+/**
+ * A terminal window that rendered frames are drawn to.
+ */
+class Display
+{
+public:
+    /**
+     * Create new window. Requires ncurses to be initialized.
+     *
+     * @param rows Number of rows, in cells.
+     * @param cols Number of columns, in cells.
+     * @param begin_row Row of the top left corner of the window.
+     * @param begin_col Column of the top left corner of the window.
+     */
+    Display(int rows, int cols, int begin_row = 0, int begin_col = 0);
+
+    // NOTE: copy constructors are deleted since the window is deleted on destruction
+    Display(const Display&) = delete;
+    Display& operator=(const Display&) = delete;
+
+    Display(Display&& other);
+    Display& operator=(Display&& other);
+
+    ~Display();
+
+    /**
+     * Draw a frame to the window, along with a border. The window is not refreshed until `doupdate()` is called.
+     *
+     * @param frame Buffers of a rendered frame. Its size should be `image_height()` by `image_width()`.
+     */
+    void present(const FrameArena& frame);
+
+    /**
+     * Set how pixels are drawn to the terminal. This changes the image size.
+     */
+    inline void set_presentation(Presentation presentation) { _presentation = presentation; }
+
+    inline Presentation presentation() const { return _presentation; }
+
+    /**
+     * Height of the images that fill the window, in pixels.
+     */
+    inline int image_height() const { return getmaxy(_window) * (_presentation == Presentation::HalfBlock ? 2 : 1); }
+
+    /**
+     * Width of the images that fill the window, in pixels.
+     */
+    inline int image_width() const { return getmaxx(_window); }
+
+    inline WINDOW* window() const { return _window; }
+
+private:
+    /**
+     * Draw the pixels of a frame with two pixels per cell. See `Presentation::HalfBlock`.
+     */
+    void present_half_blocks(const FrameArena& frame);
+
+    WINDOW* _window;
+
+    Presentation _presentation = Presentation::Block;
+    ColorPairCache pair_cache;
+};
+
+}  // namespace raster
@@ -0,0 +1,77 @@
+#include <raster/exporter.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <new>
+
+
+namespace raster
+{
+
+FrameExporter::FrameExporter(const char* name, int max_height, int max_width)
+    : name(name), size(shm::size(max_height, max_width))
+{
+    const int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        return;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    // NOTE: the mapping stays valid after the file descriptor is closed
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return;
+    }
+
+    // the memory is zero-filled, so all sequence numbers start at zero
+    header = new (memory) shm::Header{};
+    header->magic = shm::MAGIC;
+    header->version = shm::VERSION;
+    header->max_height = max_height;
+    header->max_width = max_width;
+    header->depth_scale = FrameArena::DEPTH_SCALE;
+}
+
+FrameExporter::~FrameExporter()
+{
+    if (header) {
+        munmap(header, size);
+        shm_unlink(name.c_str());
+    }
+}
+
+void FrameExporter::publish(const FrameArena& frame)
+{
+    const int height = frame.height;
+    const int width = frame.width;
+    if (!header || height > header->max_height || width > header->max_width) {
+        return;
+    }
+
+    const uint64_t frame_index = header->num_frames.load(std::memory_order_relaxed);
+    const uint32_t slot_index = frame_index % shm::NUM_SLOTS;
+    shm::Slot& slot = header->slots[slot_index];
+
+    // mark the slot as being written. the fence keeps the writes below from being reordered before the mark
+    const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.frame = frame_index;
+    slot.height = height;
+    slot.width = width;
+    frame.read_color_pairs(shm::color_pairs(header, slot_index));
+    frame.read_depth(shm::depth(header, slot_index));
+
+    // mark the slot as written, then announce the frame
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->num_frames.store(frame_index + 1, std::memory_order_release);
+}
+
+}  // namespace raster
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <raster/frame.hpp>
+#include <raster/shm.hpp>
+
+#include <string>
+
+
+namespace raster
+{
+
+/**
+ * Exports rendered frames to POSIX shared memory, so that other processes can read them without scraping the terminal.
+ *
+ * Frames are written to a ring buffer of slots, each guarded by a sequence lock. See `raster/shm.hpp` for the layout.
+ * Publishing a frame is a copy of its buffers into shared memory; it never waits for readers or makes system calls.
+ */
+class FrameExporter
+{
+public:
+    /**
+     * Create the shared memory object. Check `is_open()` for success.
+     *
+     * @param name Name of the shared memory object, e.g. "/raster". Replaces any existing object with the same name.
+     * @param max_height Height of the largest frame to export, in pixels.
+     * @param max_width Width of the largest frame to export, in pixels.
+     */
+    FrameExporter(const char* name, int max_height, int max_width);
+
+    // NOTE: copy constructors are deleted since the shared memory is unlinked on destruction
+    FrameExporter(const FrameExporter&) = delete;
+    FrameExporter& operator=(const FrameExporter&) = delete;
+
+    /**
+     * Unmap and unlink the shared memory object.
+     */
+    ~FrameExporter();
+
+    /**
+     * Returns true if the shared memory object was created.
+     */
+    inline bool is_open() const { return header != nullptr; }
+
+    /**
+     * Publish a frame. Frames larger than the maximum size are skipped.
+     *
+     * @param frame Buffers of a rendered frame.
+     */
+    void publish(const FrameArena& frame);
+
+private:
+    const std::string name;
+    const size_t size;
+
+    // Start of the mapped shared memory. Null if it could not be created.
+    shm::Header* header = nullptr;
+};
+
+}  // namespace raster
@@ -0,0 +1,64 @@
+#include <raster/frame.hpp>
+
+#include <algorithm>
+
+
+namespace raster
+{
+
+void FrameArena::resize(int height, int width)
+{
+    if (height == this->height && width == this->width) {
+        return;
+    }
+    this->height = height;
+    this->width = width;
+
+    // NOTE: partial tiles at the right and bottom edges are padded to whole tiles
+    tiles_per_row = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_per_col = (height + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t size = static_cast<size_t>(tiles_per_row) * tiles_per_col * TILE_SIZE * TILE_SIZE;
+    depth.resize(size);
+    color_pairs.resize(size);
+}
+
+void FrameArena::resize_vertices(size_t num_vertices)
+{
+    camera_vertices.resize(num_vertices);
+    pixel_vertices.resize(num_vertices);
+}
+
+void FrameArena::clear()
+{
+    std::fill(depth.begin(), depth.end(), 0);
+    std::fill(color_pairs.begin(), color_pairs.end(), 0);
+}
+
+void FrameArena::read_color_pairs(uint8_t* out) const
+{
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; col += TILE_SIZE) {
+            // copy the part of the row that lies in a tile at once
+            const int n = std::min(TILE_SIZE, width - col);
+            out = std::copy_n(color_pairs.data() + index(row, col), n, out);
+        }
+    }
+}
+
+void FrameArena::read_depth(uint16_t* out) const
+{
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; col += TILE_SIZE) {
+            const int n = std::min(TILE_SIZE, width - col);
+            out = std::copy_n(depth.data() + index(row, col), n, out);
+        }
+    }
+}
+
+void VertexArena::resize(size_t num_vertices)
+{
+    world_vertices.resize(num_vertices);
+    linear_colors.resize(num_vertices);
+}
+
+}  // namespace raster
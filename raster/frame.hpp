@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * Buffers used while rendering a frame.
+ *
+ * The buffers are owned by the renderer and reused across frames. They only reallocate when the image size changes or
+ * when a larger mesh is drawn, so rendering in a steady state does not allocate memory.
+ *
+ * The image buffers are packed: depth is stored as a 16-bit normalized reciprocal, see `pack_depth()`, and color pairs
+ * as 8-bit indices. They are split into square tiles of `TILE_SIZE` pixels, each stored contiguously, so that pixels
+ * that are close on screen are also close in memory. See `index()`.
+ */
+struct FrameArena {
+    // Size of the tiles of the image buffers, in pixels
+    static constexpr int TILE_SIZE = 8;
+    // Nearest depth that can be told apart. Anything closer has the same packed depth, so the camera does not draw it.
+    static constexpr float DEPTH_NEAR = 0.05f;
+    // Packed depth of a z-coordinate is `DEPTH_SCALE / z`
+    static constexpr float DEPTH_SCALE = DEPTH_NEAR * std::numeric_limits<uint16_t>::max();
+
+    // Image size, in pixels
+    int height = 0;
+    int width = 0;
+    // Number of tiles per row of tiles
+    int tiles_per_row = 0;
+
+    // Packed depth of each pixel. Zero if nothing has been drawn; otherwise larger is closer.
+    std::vector<uint16_t> depth;
+    // ncurses color pair of each pixel. Zero if nothing has been drawn.
+    std::vector<uint8_t> color_pairs;
+
+    // Vertices of the mesh being drawn, in camera coordinates.
+    std::vector<Eigen::Vector3f> camera_vertices;
+    // Vertices of the mesh being drawn, in pixel coordinates. Only valid for vertices in front of the camera.
+    std::vector<Eigen::Vector2f> pixel_vertices;
+
+    /**
+     * Resize the image buffers. Does nothing if the size has not changed.
+     *
+     * @param height Image height, in pixels.
+     * @param width Image width, in pixels.
+     */
+    void resize(int height, int width);
+
+    /**
+     * Resize the vertex buffers. Only reallocates if the mesh is larger than any mesh drawn before.
+     *
+     * @param num_vertices Number of vertices of the mesh being drawn.
+     */
+    void resize_vertices(size_t num_vertices);
+
+    /**
+     * Clear the image buffers.
+     */
+    void clear();
+
+    /**
+     * Index of a pixel in the image buffers.
+     */
+    inline size_t index(int row, int col) const
+    {
+        const size_t tile = static_cast<size_t>(row / TILE_SIZE) * tiles_per_row + col / TILE_SIZE;
+        return tile * TILE_SIZE * TILE_SIZE + (row % TILE_SIZE) * TILE_SIZE + col % TILE_SIZE;
+    }
+
+    /**
+     * Pack a depth, given as the reciprocal of its z-coordinate in camera space, i.e. `1 / z`. Reciprocals are linear
+     * in screen space, and packing them spends the precision on the nearest depths.
+     *
+     * @param inv_z Reciprocal of the z-coordinate. Must be positive.
+     * @returns Packed depth in [1, 65535].
+     */
+    static inline uint16_t pack_depth(float inv_z)
+    {
+        constexpr float max_depth = std::numeric_limits<uint16_t>::max();
+        return static_cast<uint16_t>(std::clamp(DEPTH_SCALE * inv_z + 0.5f, 1.f, max_depth));
+    }
+
+    /**
+     * Unpack a depth to its z-coordinate in camera space.
+     *
+     * @param depth Packed depth. Must not be zero.
+     */
+    static inline float unpack_depth(uint16_t depth) { return DEPTH_SCALE / depth; }
+
+    /**
+     * Copy the color pairs in row-major order.
+     *
+     * @param[out] out Buffer of `height * width` color pairs.
+     */
+    void read_color_pairs(uint8_t* out) const;
+
+    /**
+     * Copy the packed depths in row-major order.
+     *
+     * @param[out] out Buffer of `height * width` packed depths.
+     */
+    void read_depth(uint16_t* out) const;
+};
+
+/**
+ * Vertex buffers used while rendering a frame that do not depend on the camera.
+ *
+ * They hold the result of the vertex work in world space, so that it can be shared by several cameras. Like
+ * `FrameArena`, they are reused across frames.
+ */
+struct VertexArena {
+    // Vertices of the mesh being drawn, in world coordinates. Only filled in when several cameras share them.
+    std::vector<Eigen::Vector3f> world_vertices;
+    // Vertex colors of the mesh being drawn, in linear color space. Lit, if lighting is enabled.
+    std::vector<Eigen::Array3f> linear_colors;
+
+    /**
+     * Resize the buffers. Only reallocates if the mesh is larger than any mesh drawn before.
+     *
+     * @param num_vertices Number of vertices of the mesh being drawn.
+     */
+    void resize(size_t num_vertices);
+};
+
+}  // namespace raster
@@ -0,0 +1,89 @@
+#include <raster/input.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace raster
+{
+
+InputQueue::InputQueue(WINDOW* window) : window(window) {}
+
+void InputQueue::poll()
+{
+    wtimeout(window, 0);
+    while (read()) {
+    }
+}
+
+void InputQueue::wait_until(clock::time_point deadline)
+{
+    while (true) {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        wtimeout(window, remaining.count());
+        read();
+    }
+
+    // also take keys that arrived at the deadline
+    poll();
+}
+
+bool InputQueue::pop(clock::time_point time, Event& event)
+{
+    if (_size == 0 || events[first].arrival > time) {
+        return false;
+    }
+    event = events[first];
+    first = (first + 1) % CAPACITY;
+    --_size;
+    return true;
+}
+
+bool InputQueue::read()
+{
+    const int key = wgetch(window);
+    if (key == ERR) {
+        return false;
+    }
+
+    // NOTE: keys are read even when the queue is full. leaving them in the input buffer would make `wait_until()` spin
+    // until the deadline, and would stamp them with a later arrival time, which under-reports their latency
+    if (_size == CAPACITY) {
+        ++_dropped;
+        return true;
+    }
+    events[(first + _size) % CAPACITY] = {.key = key, .arrival = clock::now()};
+    ++_size;
+    return true;
+}
+
+void LatencyHistogram::add(duration latency)
+{
+    const size_t bucket = std::max(latency / RESOLUTION, 0.0);
+    ++buckets[std::min(bucket, NUM_BUCKETS - 1)];
+    ++_count;
+}
+
+LatencyHistogram::duration LatencyHistogram::percentile(double fraction) const
+{
+    if (_count == 0) {
+        return duration::zero();
+    }
+
+    // find the first bucket at which the cumulative count reaches the fraction of samples
+    const long target = std::max<long>(std::ceil(fraction * _count), 1);
+    long cumulative = 0;
+    size_t bucket = 0;
+    for (; bucket < NUM_BUCKETS - 1; ++bucket) {
+        cumulative += buckets[bucket];
+        if (cumulative >= target) {
+            break;
+        }
+    }
+    return RESOLUTION * (bucket + 1);
+}
+
+}  // namespace raster
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <ncurses.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+
+namespace raster
+{
+
+/**
+ * Queue of keys read from the terminal, in the order they arrived, with their arrival times.
+ *
+ * Keys are read whenever the application would otherwise be idle, i.e. while waiting for the next frame, so that
+ * arrival times are accurate. Keys that arrive while a frame is being rendered are read at the start of the next
+ * frame. The queue has a fixed capacity, so it never allocates memory. When it is full, keys are still read, so that
+ * the arrival times of later keys stay accurate, but they are dropped and counted, see `dropped()`.
+ */
+class InputQueue
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * A key and the time that it was read.
+     */
+    struct Event {
+        int key;
+        clock::time_point arrival;
+    };
+
+    // Maximum number of queued events
+    static constexpr size_t CAPACITY = 256;
+
+    /**
+     * Create queue.
+     *
+     * @param window Window to read keys from.
+     */
+    InputQueue(WINDOW* window);
+
+    /**
+     * Read all keys that are pending, without waiting.
+     */
+    void poll();
+
+    /**
+     * Read keys as they arrive until the given time.
+     */
+    void wait_until(clock::time_point deadline);
+
+    /**
+     * Take the oldest event if it arrived no later than the given time.
+     *
+     * @param[in] time Latest arrival time to take.
+     * @param[out] event The oldest event.
+     * @returns False if there is no such event.
+     */
+    bool pop(clock::time_point time, Event& event);
+
+    inline size_t size() const { return _size; }
+
+    /**
+     * Number of keys that were dropped because the queue was full.
+     */
+    inline long dropped() const { return _dropped; }
+
+private:
+    /**
+     * Read one key, if any arrives before the `wgetch()` timeout of the window. If the queue is full, the key is
+     * dropped.
+     *
+     * @returns False if no key was read.
+     */
+    bool read();
+
+    WINDOW* window;
+
+    // Ring buffer of events
+    std::array<Event, CAPACITY> events;
+    // Index of the oldest event
+    size_t first = 0;
+    size_t _size = 0;
+    long _dropped = 0;
+};
+
+/**
+ * Histogram of latencies, with a fixed resolution and range so that adding samples never allocates memory.
+ */
+class LatencyHistogram
+{
+public:
+    using duration = std::chrono::duration<double>;
+
+    /**
+     * Add a sample. Latencies beyond the range of the histogram are counted in the last bucket.
+     */
+    void add(duration latency);
+
+    /**
+     * Latency below which the given fraction of the samples lie, e.g. 0.5 for the median. Rounded up to the
+     * resolution of the histogram. Zero if there are no samples.
+     *
+     * @param fraction Fraction in [0, 1].
+     */
+    duration percentile(double fraction) const;
+
+    /**
+     * Number of samples.
+     */
+    inline long count() const { return _count; }
+
+private:
+    // Width of a bucket
+    static constexpr duration RESOLUTION = std::chrono::microseconds(100);
+    // Number of buckets. Together, they cover latencies of up to one second.
+    static constexpr size_t NUM_BUCKETS = 10000;
+
+    std::array<long, NUM_BUCKETS> buckets = {};
+    long _count = 0;
+};
+
+}  // namespace raster
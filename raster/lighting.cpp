@@ -0,0 +1,89 @@
+#include <raster/lighting.hpp>
+
+#include <algorithm>
+
+#include <cassert>
+
+
+namespace
+{
+
+// Number of vertices lit together. Chunks are kept small enough to live on the stack.
+constexpr int CHUNK_SIZE = 64;
+
+// Smallest squared distance from a point light to a vertex. Keeps the falloff finite for vertices at the light.
+constexpr float MIN_SQUARED_DISTANCE = 1e-6f;
+
+// Column of values for each vertex of a chunk. NOTE: Eigen requires row vectors to be row-major
+template <int Rows>
+using Chunk =
+    Eigen::Matrix<float, Rows, Eigen::Dynamic, Rows == 1 ? Eigen::RowMajor : Eigen::ColMajor, Rows, CHUNK_SIZE>;
+
+}  // namespace
+
+
+namespace raster
+{
+
+void light_vertices(
+    const Lighting& lighting,
+    const Eigen::Affine3f& model_to_world,
+    const std::vector<Eigen::Vector3f>& vertices,
+    const std::vector<Eigen::Vector3f>& normals,
+    std::vector<Eigen::Array3f>& colors)
+{
+    assert(vertices.size() == normals.size() && vertices.size() == colors.size());
+
+    // NOTE: the mesh is empty until the loader publishes geometry, and `data()` may then be null
+    const int n = vertices.size();
+    if (n == 0) {
+        return;
+    }
+
+    // view the vertices, normals and colors as 3xN matrices
+    const Eigen::Map<const Eigen::Matrix3Xf> all_vertices(vertices.data()->data(), 3, n);
+    const Eigen::Map<const Eigen::Matrix3Xf> all_normals(normals.data()->data(), 3, n);
+    Eigen::Map<Eigen::Array3Xf> all_colors(colors.data()->data(), 3, n);
+
+    for (int idx = 0; idx < n; idx += CHUNK_SIZE) {
+        const int m = std::min(CHUNK_SIZE, n - idx);
+
+        // rotate normals into world coordinates and normalize them. zero normals stay zero
+        Chunk<3> world_normals = model_to_world.linear() * all_normals.middleCols(idx, m);
+        const Chunk<1> norms = world_normals.colwise().norm();
+        world_normals.array().rowwise() /= (norms.array() > 0).select(norms.array(), 1.f);
+
+        // positions are only needed for point lights
+        Chunk<3> world_vertices(3, m);
+        bool has_world_vertices = false;
+
+        // accumulate light reaching each vertex
+        Chunk<3> irradiance = lighting.ambient.matrix().replicate(1, m);
+        for (const Light& light : lighting.lights) {
+            Chunk<1> cos_angle(1, m);
+            switch (light.type) {
+                case Light::Type::Directional: {
+                    cos_angle = -light.vector.normalized().transpose() * world_normals;
+                    break;
+                }
+                case Light::Type::Point: {
+                    if (!has_world_vertices) {
+                        world_vertices = model_to_world * all_vertices.middleCols(idx, m).colwise().homogeneous();
+                        has_world_vertices = true;
+                    }
+                    const Chunk<3> to_light = (-world_vertices).colwise() + light.vector;
+                    const Chunk<1> squared_dists = to_light.colwise().squaredNorm().cwiseMax(MIN_SQUARED_DISTANCE);
+                    // divide by distance once to normalize `to_light`, and twice more for the falloff
+                    cos_angle = to_light.cwiseProduct(world_normals).colwise().sum().cwiseQuotient(
+                        squared_dists.cwiseProduct(squared_dists.cwiseSqrt()));
+                    break;
+                }
+            }
+            irradiance += light.intensity.matrix() * cos_angle.cwiseMax(0.f);
+        }
+
+        all_colors.middleCols(idx, m) *= irradiance.array();
+    }
+}
+
+}  // namespace raster
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * A light source.
+ */
+struct Light {
+    enum class Type {
+        // Light arriving from the same direction everywhere, e.g. the sun.
+        Directional,
+        // Light emitted from a point in all directions. Falls off with the square of the distance.
+        Point,
+    };
+
+    Type type;
+    // For directional lights, the direction that the light travels in. For point lights, the position of the light.
+    // In world coordinates.
+    Eigen::Vector3f vector;
+    // Intensity of the light, per color channel in linear color space.
+    Eigen::Array3f intensity;
+};
+
+/**
+ * Lights of a scene.
+ */
+struct Lighting {
+    // Light that reaches every surface regardless of orientation, per color channel in linear color space.
+    Eigen::Array3f ambient = Eigen::Array3f::Constant(0.2f);
+    std::vector<Light> lights;
+};
+
+/**
+ * Apply diffuse (Lambertian) lighting to the vertices of a mesh. All vertices are lit in one vectorized pass, so that
+ * shading does not need to evaluate lights per pixel.
+ *
+ * @param[in] lighting Lights of the scene.
+ * @param[in] model_to_world Pose of the mesh, i.e. the transformation from mesh coordinates to world coordinates.
+ * @param[in] vertices Vertices, as 3D points in mesh coordinates.
+ * @param[in] normals Vertex normals, in mesh coordinates. Need not be normalized.
+ * @param[in,out] colors Vertex colors in linear color space, which are multiplied by the light reaching each vertex.
+ */
+void light_vertices(
+    const Lighting& lighting,
+    const Eigen::Affine3f& model_to_world,
+    const std::vector<Eigen::Vector3f>& vertices,
+    const std::vector<Eigen::Vector3f>& normals,
+    std::vector<Eigen::Array3f>& colors);
+
+}  // namespace raster
@@ -0,0 +1,142 @@
+#include <raster/loader.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+
+// Number of lines to parse before publishing a batch
+constexpr int LINES_PER_BATCH = 4096;
+
+}  // namespace
+
+
+namespace raster
+{
+
+MeshLoader::MeshLoader(const char* obj)
+{
+    std::error_code ec;
+    bytes_total = std::filesystem::file_size(obj, ec);
+    if (ec) {
+        bytes_total = 0;
+    }
+
+    thread = std::jthread(
+        [this](std::stop_token stop_token, std::string obj) { load(stop_token, std::move(obj)); }, std::string(obj));
+}
+
+MeshLoader::~MeshLoader()
+{
+    thread.request_stop();
+    thread.join();
+
+    Node* node = published.exchange(nullptr);
+    while (node != nullptr) {
+        delete std::exchange(node, node->next);
+    }
+}
+
+bool MeshLoader::poll(Mesh& mesh)
+{
+    // take all published batches at once, then reverse them to get the order they were published in
+    Node* node = published.exchange(nullptr, std::memory_order_acquire);
+    if (node == nullptr) {
+        return false;
+    }
+
+    Node* oldest = nullptr;
+    while (node != nullptr) {
+        Node* next = node->next;
+        node->next = oldest;
+        oldest = node;
+        node = next;
+    }
+
+    while (oldest != nullptr) {
+        mesh.extend(std::move(oldest->batch));
+        delete std::exchange(oldest, oldest->next);
+    }
+    return true;
+}
+
+float MeshLoader::progress() const
+{
+    if (finished.load()) {
+        return 1.f;
+    }
+    if (bytes_total == 0) {
+        return 0.f;
+    }
+    return std::min(1.f, static_cast<float>(bytes_read.load(std::memory_order_relaxed)) / bytes_total);
+}
+
+bool MeshLoader::done() const
+{
+    return finished.load(std::memory_order_acquire) && published.load(std::memory_order_acquire) == nullptr;
+}
+
+const std::string& MeshLoader::error() const
+{
+    static const std::string no_error;
+    return finished.load(std::memory_order_acquire) ? _error : no_error;
+}
+
+void MeshLoader::load(std::stop_token stop_token, std::string obj)
+{
+    std::ifstream f(obj);
+    if (!f.is_open()) {
+        _error = "cannot open " + obj;
+        finished.store(true, std::memory_order_release);
+        return;
+    }
+    obj::Parser parser(obj.c_str());
+
+    std::string line;
+    long line_number = 0;
+    int num_lines = 0;
+    while (!stop_token.stop_requested() && getline(f, line)) {
+        ++line_number;
+        try {
+            parser.parse_line(line);
+        } catch (const std::invalid_argument&) {
+            _error = obj + ":" + std::to_string(line_number) + ": malformed line: " + line;
+            break;
+        } catch (const std::out_of_range&) {
+            _error = obj + ":" + std::to_string(line_number) + ": value out of range: " + line;
+            break;
+        }
+        bytes_read.fetch_add(line.size() + 1, std::memory_order_relaxed);
+
+        if (++num_lines == LINES_PER_BATCH) {
+            publish(parser.take());
+            num_lines = 0;
+        }
+    }
+    publish(parser.take());
+
+    // faces that are still pending refer to vertices or texture coordinates past the end of the file
+    if (_error.empty() && !stop_token.stop_requested() && parser.first_pending_face_line() > 0) {
+        _error = obj + ":" + std::to_string(parser.first_pending_face_line()) + ": face index out of range";
+    }
+
+    finished.store(true, std::memory_order_release);
+}
+
+void MeshLoader::publish(obj::Batch&& batch)
+{
+    if (batch.vertices.empty() && batch.uvs.empty() && batch.face_vertex_indices.empty() && !batch.texture) {
+        return;
+    }
+
+    Node* node = new Node{.batch = std::move(batch), .next = published.load(std::memory_order_relaxed)};
+    while (!published.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace raster
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <raster/mesh.hpp>
+#include <raster/obj.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+
+namespace raster
+{
+
+/**
+ * Loads a mesh from a .obj file on a background thread.
+ *
+ * Geometry is published in batches as the file is parsed. The batches are handed off to the rendering thread through
+ * a lock-free list, so a partially loaded mesh can be rendered while the rest of the file is read.
+ */
+class MeshLoader
+{
+public:
+    /**
+     * Start loading a mesh.
+     *
+     * @param obj Path to file.
+     */
+    MeshLoader(const char* obj);
+
+    // NOTE: copy and move constructors are deleted since the background thread refers to this object
+    MeshLoader(const MeshLoader&) = delete;
+    MeshLoader& operator=(const MeshLoader&) = delete;
+
+    /**
+     * Stop loading and wait for the background thread to finish.
+     */
+    ~MeshLoader();
+
+    /**
+     * Append all geometry that has been published since the last call to the given mesh. Never blocks.
+     *
+     * @param mesh Mesh being loaded.
+     * @returns True if any geometry was appended.
+     */
+    bool poll(Mesh& mesh);
+
+    /**
+     * Fraction of the file that has been read, in [0, 1].
+     */
+    float progress() const;
+
+    /**
+     * Returns true once the whole file has been read and all of its geometry has been handed off by `poll()`.
+     */
+    bool done() const;
+
+    /**
+     * Describes why loading failed, e.g. because the file could not be opened or has a malformed line. Empty if
+     * loading succeeded or has not finished yet. Geometry published before the failure is still handed off by
+     * `poll()`.
+     */
+    const std::string& error() const;
+
+private:
+    /**
+     * Node of the list of published batches.
+     */
+    struct Node {
+        obj::Batch batch;
+        Node* next;
+    };
+
+    /**
+     * Load the file. Runs on the background thread.
+     */
+    void load(std::stop_token stop_token, std::string obj);
+
+    /**
+     * Publish a batch to the rendering thread.
+     */
+    void publish(obj::Batch&& batch);
+
+    // Most recently published batch. Batches are linked from newest to oldest.
+    std::atomic<Node*> published = nullptr;
+
+    // Number of bytes of the file that have been read
+    std::atomic<size_t> bytes_read = 0;
+    // Size of the file, in bytes
+    size_t bytes_total = 0;
+    // Whether the whole file has been read, or loading failed
+    std::atomic<bool> finished = false;
+    // Why loading failed. Written by the background thread before `finished` is set.
+    std::string _error;
+
+    // NOTE: declared last so that the thread starts after all other members are initialized
+    std::jthread thread;
+};
+
+}  // namespace raster
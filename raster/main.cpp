@@ -1,20 +1,203 @@
 #include <raster/app.hpp>
+#include <raster/batch.hpp>
+#include <raster/exporter.hpp>
+#include <raster/loader.hpp>
 
 #include <ncurses.h>
 
+#include <charconv>
+#include <chrono>
+#include <clocale>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numbers>
+#include <string_view>
+#include <thread>
 
-int main()
+
+namespace
+{
+
+// Size of the window, in cells
+constexpr int WINDOW_ROWS = 128;
+constexpr int WINDOW_COLS = 128;
+
+/**
+ * Parse a number from a command-line argument.
+ *
+ * @param arg Argument to parse.
+ * @param[out] value Parsed number. Unchanged if the argument is not a number.
+ * @returns Whether the whole argument is a number.
+ */
+template <typename T>
+bool parse_number(std::string_view arg, T& value)
+{
+    T parsed;
+    const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), parsed);
+    if (error != std::errc() || end != arg.data() + arg.size()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+/**
+ * Render frames of a mesh offline and write them to a file, see `BatchRenderer`. The mesh spins in place while the
+ * camera orbits around it once.
+ *
+ * @param obj Path to .obj file of the mesh.
+ * @param out_path Path of the output file.
+ * @param num_frames Number of frames to render.
+ * @param num_threads Number of threads to render with.
+ * @returns Exit code.
+ */
+int render_batch(const char* obj, const char* out_path, int num_frames, int num_threads)
+{
+    std::ofstream out(out_path, std::ios::binary);
+    if (!out) {
+        std::cerr << "cannot open " << out_path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // load the whole mesh up front
+    raster::Mesh mesh;
+    raster::MeshLoader loader(obj);
+    while (!loader.done()) {
+        if (!loader.poll(mesh)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (!loader.error().empty()) {
+        std::cerr << loader.error() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    raster::Scene scene;
+    const size_t mesh_idx = scene.add_mesh(std::move(mesh));
+    scene.add_instance(mesh_idx, Eigen::Affine3f::Identity(), 1.f, 1.f, Eigen::Vector3f::Zero(), {0, 0.01, 0.02});
+    scene.lighting().lights.push_back(
+        {.type = raster::Light::Type::Directional,
+         .vector = Eigen::Vector3f(-1, 0.5, -1),
+         .intensity = Eigen::Array3f::Constant(0.8f)});
+
+    // simulate the scene and move the camera along its path. NOTE: this is sequential, since each physics tick depends
+    // on the previous one, but it is cheap compared to rendering
+    raster::Camera camera(1, 1, 0.f);
+    std::vector<raster::FramePoses> frames(num_frames);
+    for (int frame = 0; frame < num_frames; ++frame) {
+        const float angle = 2 * std::numbers::pi * frame / num_frames;
+        camera.set_pose(Eigen::Affine3f(Eigen::Translation3f(2 * std::cos(angle), 2 * std::sin(angle), 0.5f)));
+        camera.look_at(Eigen::Vector3f(0, 0, 0));
+        frames[frame].camera_to_world = camera.pose();
+
+        for (size_t instance = 0; instance < scene.num_instances(); ++instance) {
+            frames[frame].instance_poses.push_back(scene.pose(instance));
+        }
+        scene.tick();
+    }
+
+    const auto t_start = std::chrono::steady_clock::now();
+    raster::BatchRenderer renderer(WINDOW_ROWS, WINDOW_COLS, std::numbers::pi / 2, num_threads);
+    if (!renderer.render(scene, frames, out)) {
+        std::cerr << "cannot write " << out_path << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t_start;
+
+    std::cout << "frames: " << num_frames << " (" << num_frames / elapsed.count() << " fps, " << num_threads
+              << " threads)" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+
+int main(int argc, char** argv)
 {
-    // init ncurses
+    // parse arguments
+    const char* obj = "data/cube.obj";
+    double frames_per_sec = 30.0;
+    const char* shm_name = nullptr;
+    const char* batch_path = nullptr;
+    int num_frames = 300;
+    int num_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--obj" && i + 1 < argc) {
+            obj = argv[++i];
+        } else if (arg == "--fps" && i + 1 < argc) {
+            // non-positive values mean that frames are rendered as fast as possible
+            if (!parse_number(argv[++i], frames_per_sec)) {
+                std::cerr << "invalid --fps: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--export-shm" && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            if (!parse_number(argv[++i], num_frames) || num_frames < 0) {
+                std::cerr << "invalid --frames: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!parse_number(argv[++i], num_threads) || num_threads < 1) {
+                std::cerr << "invalid --threads: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--obj OBJ_FILE] [--fps FRAMES_PER_SEC] [--export-shm NAME]"
+                      << " [--batch OUT_FILE [--frames NUM_FRAMES] [--threads NUM_THREADS]]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // render offline without a window
+    if (batch_path) {
+        return render_batch(obj, batch_path, num_frames, num_threads);
+    }
+
+    // create shared memory before starting ncurses, so that errors can be printed. NOTE: frames can have up to two
+    // pixels per cell, see `Presentation::HalfBlock`
+    std::unique_ptr<raster::FrameExporter> exporter;
+    if (shm_name) {
+        exporter = std::make_unique<raster::FrameExporter>(shm_name, 2 * WINDOW_ROWS, WINDOW_COLS);
+        if (!exporter->is_open()) {
+            std::cerr << "cannot create shared memory " << shm_name << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // init ncurses. the locale is needed to draw unicode characters
+    std::setlocale(LC_ALL, "");
     initscr();
     cbreak();
     noecho();
 
-    raster::App app(128, 128);
+    raster::App app(WINDOW_ROWS, WINDOW_COLS, obj, frames_per_sec);
+    if (exporter) {
+        app.export_frames(std::move(exporter));
+    }
     app.run();
 
     // end ncurses
     endwin();
 
+    if (!app.error().empty()) {
+        std::cerr << app.error() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // print stats
+    const auto& stats = app.stats();
+    std::cout << "time to first frame: " << 1000 * stats.time_to_first_frame.count() << " ms" << std::endl;
+    std::cout << "frames: " << stats.frames << " (" << stats.frames / stats.elapsed.count() << " fps)" << std::endl;
+    std::cout << "ticks: " << stats.ticks << " (" << stats.ticks / stats.elapsed.count() << " ticks/s)" << std::endl;
+    std::cout << "input latency: " << stats.input_latency.count() << " keys, p50 "
+              << 1000 * stats.input_latency.percentile(0.5).count() << " ms, p99 "
+              << 1000 * stats.input_latency.percentile(0.99).count() << " ms, " << stats.dropped_keys << " dropped"
+              << std::endl;
+
     return EXIT_SUCCESS;
 }
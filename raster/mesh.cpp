@@ -2,6 +2,8 @@
 
 #include <raster/io.hpp>
 
+#include <cassert>
+
 
 namespace raster
 {
@@ -10,64 +12,99 @@ Mesh::Mesh(
     std::vector<Eigen::Vector3f>&& vertices,
     std::vector<Eigen::Array3f>&& vertex_colors,
     std::vector<Eigen::Array3i>&& face_vertex_indices)
-    : vertices(vertices),
-      vertex_colors(vertex_colors),
-      face_vertex_indices(face_vertex_indices)
+    : _vertices(std::move(vertices)),
+      _vertex_colors(std::move(vertex_colors)),
+      _face_vertex_indices(std::move(face_vertex_indices))
 {
-    assert(vertices.size() == vertex_colors.size());
+    assert(_vertices.size() == _vertex_colors.size());
+    add_face_normals(0);
 }
 
 Mesh::Mesh(const char* obj)
 {
-    const std::vector<std::string> lines = io::read_lines(obj);
-    for (const auto& line : lines) {
-        const std::vector<std::string> parts = io::split(line, " ");
-        if (parts.size() == 0) {
-            continue;
-        }
-        if (parts[0] == "v") {
-            assert(parts.size() >= 7);
-            vertices.emplace_back(std::stof(parts[1]), std::stof(parts[2]), std::stof(parts[3]));
-            vertex_colors.emplace_back(std::stof(parts[4]), std::stof(parts[5]), std::stof(parts[6]));
-        } else if (parts[0] == "f") {
-            assert(parts.size() >= 4);
-            face_vertex_indices.emplace_back(std::stoi(parts[1]) - 1, std::stoi(parts[2]) - 1, std::stoi(parts[3]) - 1);
-        }
+    obj::Parser parser(obj);
+    for (const auto& line : io::read_lines(obj)) {
+        parser.parse_line(line);
     }
+    extend(parser.take());
 }
 
 Mesh::Mesh(Mesh&& other)
-    : vertices(std::move(other.vertices)),
-      vertex_colors(std::move(other.vertex_colors)),
-      face_vertex_indices(std::move(other.face_vertex_indices))
+    : _vertices(std::move(other._vertices)),
+      _vertex_colors(std::move(other._vertex_colors)),
+      _vertex_normals(std::move(other._vertex_normals)),
+      _face_vertex_indices(std::move(other._face_vertex_indices)),
+      _uvs(std::move(other._uvs)),
+      _face_uv_indices(std::move(other._face_uv_indices)),
+      _texture(std::move(other._texture))
 {
 }
 
 Mesh& Mesh::operator=(Mesh&& other)
 {
-    vertices = std::move(other.vertices);
-    vertex_colors = std::move(other.vertex_colors);
-    face_vertex_indices = std::move(other.face_vertex_indices);
+    _vertices = std::move(other._vertices);
+    _vertex_colors = std::move(other._vertex_colors);
+    _vertex_normals = std::move(other._vertex_normals);
+    _face_vertex_indices = std::move(other._face_vertex_indices);
+    _uvs = std::move(other._uvs);
+    _face_uv_indices = std::move(other._face_uv_indices);
+    _texture = std::move(other._texture);
     return *this;
 }
 
+void Mesh::extend(obj::Batch&& batch)
+{
+    assert(batch.vertices.size() == batch.vertex_colors.size());
+    const size_t first_face = _face_vertex_indices.size();
+    _vertices.insert(_vertices.end(), batch.vertices.begin(), batch.vertices.end());
+    _vertex_colors.insert(_vertex_colors.end(), batch.vertex_colors.begin(), batch.vertex_colors.end());
+    _face_vertex_indices.insert(
+        _face_vertex_indices.end(), batch.face_vertex_indices.begin(), batch.face_vertex_indices.end());
+    _uvs.insert(_uvs.end(), batch.uvs.begin(), batch.uvs.end());
+    _face_uv_indices.insert(_face_uv_indices.end(), batch.face_uv_indices.begin(), batch.face_uv_indices.end());
+    if (batch.texture) {
+        _texture = std::move(*batch.texture);
+    }
+    add_face_normals(first_face);
+}
+
 void Mesh::transform(const Eigen::Affine3f& t)
 {
-    for (auto& v : vertices) {
+    for (auto& v : _vertices) {
         v = t * v;
     }
+    for (auto& n : _vertex_normals) {
+        n = t.linear() * n;
+    }
+}
+
+void Mesh::add_face_normals(size_t first_face)
+{
+    _vertex_normals.resize(_vertices.size(), Eigen::Vector3f::Zero());
+    for (size_t face = first_face; face < _face_vertex_indices.size(); ++face) {
+        const Eigen::Array3i& indices = _face_vertex_indices[face];
+        const Eigen::Vector3f& v1 = _vertices[indices(0)];
+        const Eigen::Vector3f& v2 = _vertices[indices(1)];
+        const Eigen::Vector3f& v3 = _vertices[indices(2)];
+
+        // the norm of the cross product is twice the area of the face, so this weighs faces by area
+        const Eigen::Vector3f normal = (v2 - v1).cross(v3 - v1);
+        for (int i = 0; i < 3; ++i) {
+            _vertex_normals[indices(i)] += normal;
+        }
+    }
 }
 
 Face Mesh::Iterator::operator*() const
 {
-    const auto& indices = ptr->face_vertex_indices[idx];
+    const auto& indices = ptr->_face_vertex_indices[idx];
     return {
-        .v1 = ptr->vertices[indices(0)],
-        .v2 = ptr->vertices[indices(1)],
-        .v3 = ptr->vertices[indices(2)],
-        .c1 = ptr->vertex_colors[indices(0)],
-        .c2 = ptr->vertex_colors[indices(1)],
-        .c3 = ptr->vertex_colors[indices(2)]};
+        .v1 = ptr->_vertices[indices(0)],
+        .v2 = ptr->_vertices[indices(1)],
+        .v3 = ptr->_vertices[indices(2)],
+        .c1 = ptr->_vertex_colors[indices(0)],
+        .c2 = ptr->_vertex_colors[indices(1)],
+        .c3 = ptr->_vertex_colors[indices(2)]};
 }
 
 }  // namespace raster
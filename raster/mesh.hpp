@@ -1,5 +1,8 @@
 #pragma once
 
+#include <raster/obj.hpp>
+#include <raster/texture.hpp>
+
 #include <Eigen/Dense>
 
 #include <iterator>
@@ -61,11 +64,49 @@ public:
     Mesh(Mesh&& other);
     Mesh& operator=(Mesh&& other);
 
+    /**
+     * Append geometry to the mesh, e.g. while it is being loaded.
+     *
+     * @param batch Geometry to append. Face indices refer to the vertices of the extended mesh.
+     */
+    void extend(obj::Batch&& batch);
+
     /**
      * Apply an affine (i.e. rigid) transformation to the mesh.
      */
     void transform(const Eigen::Affine3f& t);
 
+    inline const std::vector<Eigen::Vector3f>& vertices() const { return _vertices; }
+
+    inline const std::vector<Eigen::Array3f>& vertex_colors() const { return _vertex_colors; }
+
+    /**
+     * Vertex normals, computed as the sum of the normals of adjacent faces weighted by their areas. They are NOT
+     * normalized, so that they can be updated as faces are added. The direction follows the winding order of faces:
+     * counter-clockwise when seen from the front.
+     */
+    inline const std::vector<Eigen::Vector3f>& vertex_normals() const { return _vertex_normals; }
+
+    inline const std::vector<Eigen::Array3i>& face_vertex_indices() const { return _face_vertex_indices; }
+
+    inline const std::vector<Eigen::Vector2f>& uvs() const { return _uvs; }
+
+    /**
+     * Texture coordinates of faces, as triples of integer indices of `uvs()`. Either empty or the same length as
+     * `face_vertex_indices()`. Indices are -1 for faces without texture coordinates.
+     */
+    inline const std::vector<Eigen::Array3i>& face_uv_indices() const { return _face_uv_indices; }
+
+    inline const Texture& texture() const { return _texture; }
+
+    /**
+     * Returns true if the mesh has a texture and texture coordinates.
+     */
+    inline bool has_texture() const
+    {
+        return !_texture.empty() && _face_uv_indices.size() == _face_vertex_indices.size();
+    }
+
     // -----------------------------------------------------------------------
 
     /**
@@ -109,12 +150,21 @@ public:
     /**
      * Iterator to the end of the collection of faces.
      */
-    inline Iterator end() const { return Iterator(this, face_vertex_indices.size()); }
+    inline Iterator end() const { return Iterator(this, _face_vertex_indices.size()); }
 
 private:
-    std::vector<Eigen::Vector3f> vertices;
-    std::vector<Eigen::Array3f> vertex_colors;
-    std::vector<Eigen::Array3i> face_vertex_indices;
+    /**
+     * Add the area-weighted normals of faces starting from index `first_face` to the vertex normals.
+     */
+    void add_face_normals(size_t first_face);
+
+    std::vector<Eigen::Vector3f> _vertices;
+    std::vector<Eigen::Array3f> _vertex_colors;
+    std::vector<Eigen::Vector3f> _vertex_normals;
+    std::vector<Eigen::Array3i> _face_vertex_indices;
+    std::vector<Eigen::Vector2f> _uvs;
+    std::vector<Eigen::Array3i> _face_uv_indices;
+    Texture _texture;
 };
 
 }  // namespace raster
@@ -0,0 +1,123 @@
+#include <raster/obj.hpp>
+
+#include <raster/io.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+
+/**
+ * Check that a line has enough parts for its statement.
+ *
+ * @throws std::invalid_argument If the line is too short.
+ */
+void check_num_parts(const std::vector<std::string>& parts, size_t min_parts)
+{
+    if (parts.size() < min_parts) {
+        throw std::invalid_argument("too few values for " + parts[0]);
+    }
+}
+
+/**
+ * Parse a face vertex of the form `v`, `v/vt`, `v//vn` or `v/vt/vn` into zero-based indices of the vertex and
+ * texture coordinates. The index of the texture coordinates is -1 if not present.
+ *
+ * @throws std::invalid_argument If an index is not a number.
+ * @throws std::out_of_range If an index is not positive. Relative (negative) indices are not supported.
+ */
+void parse_face_vertex(const std::string& str, int& vertex_index, int& uv_index)
+{
+    const std::vector<std::string> parts = raster::io::split(str, "/");
+    vertex_index = std::stoi(parts[0]) - 1;
+    uv_index = parts.size() >= 2 && !parts[1].empty() ? std::stoi(parts[1]) - 1 : -1;
+    if (vertex_index < 0 || (parts.size() >= 2 && !parts[1].empty() && uv_index < 0)) {
+        throw std::out_of_range("face index must be positive");
+    }
+}
+
+}  // namespace
+
+
+namespace raster::obj
+{
+
+Parser::Parser(const char* obj) : directory(std::filesystem::path(obj).parent_path()) {}
+
+void Parser::parse_line(const std::string& line)
+{
+    ++num_lines;
+    const std::vector<std::string> parts = io::split(line, " ");
+    if (parts.size() == 0) {
+        return;
+    }
+    if (parts[0] == "v") {
+        check_num_parts(parts, 4);
+        const Eigen::Vector3f vertex(std::stof(parts[1]), std::stof(parts[2]), std::stof(parts[3]));
+        // vertex colors are optional and default to white
+        Eigen::Array3f color(1.f, 1.f, 1.f);
+        if (parts.size() >= 7 && parts[4] != "#") {
+            color = {std::stof(parts[4]), std::stof(parts[5]), std::stof(parts[6])};
+        }
+        batch.vertices.push_back(vertex);
+        batch.vertex_colors.push_back(color);
+    } else if (parts[0] == "vt") {
+        check_num_parts(parts, 3);
+        batch.uvs.emplace_back(std::stof(parts[1]), std::stof(parts[2]));
+    } else if (parts[0] == "f") {
+        check_num_parts(parts, 4);
+        PendingFace face;
+        face.line = num_lines;
+        for (int i = 0; i < 3; ++i) {
+            parse_face_vertex(parts[i + 1], face.vertex_indices(i), face.uv_indices(i));
+        }
+        pending_faces.push_back(face);
+    } else if (parts[0] == "mtllib") {
+        check_num_parts(parts, 2);
+        parse_material_library(directory / parts[1]);
+    }
+}
+
+Batch Parser::take()
+{
+    const size_t num_vertices = num_taken_vertices + batch.vertices.size();
+    const size_t num_uvs = num_taken_uvs + batch.uvs.size();
+
+    // move faces whose vertices and texture coordinates have all been parsed into the batch
+    const auto ready =
+        std::stable_partition(pending_faces.begin(), pending_faces.end(), [=](const PendingFace& face) {
+            return static_cast<size_t>(face.vertex_indices.maxCoeff()) < num_vertices &&
+                   (face.uv_indices.maxCoeff() < 0 || static_cast<size_t>(face.uv_indices.maxCoeff()) < num_uvs);
+        });
+    for (auto it = pending_faces.begin(); it != ready; ++it) {
+        batch.face_vertex_indices.push_back(it->vertex_indices);
+        batch.face_uv_indices.push_back(it->uv_indices);
+    }
+    pending_faces.erase(pending_faces.begin(), ready);
+
+    num_taken_vertices = num_vertices;
+    num_taken_uvs = num_uvs;
+    return std::exchange(batch, {});
+}
+
+long Parser::first_pending_face_line() const
+{
+    // NOTE: pending faces stay in the order they were parsed
+    return pending_faces.empty() ? 0 : pending_faces.front().line;
+}
+
+void Parser::parse_material_library(const std::filesystem::path& mtl)
+{
+    for (const auto& line : io::read_lines(mtl.c_str())) {
+        const std::vector<std::string> parts = io::split(line, " ");
+        if (parts.size() >= 2 && parts[0] == "map_Kd") {
+            batch.texture = Texture((mtl.parent_path() / parts.back()).c_str());
+            return;
+        }
+    }
+}
+
+}  // namespace raster::obj
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <raster/texture.hpp>
+
+#include <Eigen/Dense>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace raster::obj
+{
+
+/**
+ * Geometry parsed from a .obj file. Face indices refer to all vertices and texture coordinates parsed from the file,
+ * which may include those from earlier batches.
+ */
+struct Batch {
+    // List of vertices, as 3D points in mesh coordinates.
+    std::vector<Eigen::Vector3f> vertices;
+    // List of vertex colors, as RGB values normalized to [0, 1]. Same length as `vertices`.
+    std::vector<Eigen::Array3f> vertex_colors;
+    // List of texture coordinates.
+    std::vector<Eigen::Vector2f> uvs;
+    // List of faces, represented as triples of integer indices of vertices.
+    std::vector<Eigen::Array3i> face_vertex_indices;
+    // Texture coordinates of faces, represented as triples of integer indices of texture coordinates. Same length as
+    // `face_vertex_indices`. Indices are -1 for faces without texture coordinates.
+    std::vector<Eigen::Array3i> face_uv_indices;
+    // Texture of the mesh, from the material library of the file.
+    std::optional<Texture> texture;
+};
+
+/**
+ * Incremental parser for .obj files. Lines are parsed one at a time, and the geometry parsed so far can be taken out
+ * in batches.
+ */
+class Parser
+{
+public:
+    /**
+     * Create a parser.
+     *
+     * @param obj Path to the file being parsed. Used to find material libraries and textures.
+     */
+    Parser(const char* obj);
+
+    /**
+     * Parse a line of a .obj file. If the line is malformed, nothing is added to the parsed geometry.
+     *
+     * @throws std::invalid_argument If the line is missing values or a value is not a number.
+     * @throws std::out_of_range If a value is out of range.
+     */
+    void parse_line(const std::string& line);
+
+    /**
+     * Take the geometry parsed since the last call. Faces are only included once all of their vertices and texture
+     * coordinates have been taken, either in this batch or in an earlier one.
+     */
+    Batch take();
+
+    /**
+     * Line number, counting from one, of the first face that has not been taken because it refers to vertices or
+     * texture coordinates that have not been parsed yet. Zero if there is no such face. Once the whole file has been
+     * parsed and taken, such a face refers past the end of the file.
+     */
+    long first_pending_face_line() const;
+
+private:
+    /**
+     * A face that has been parsed but not taken yet.
+     */
+    struct PendingFace {
+        Eigen::Array3i vertex_indices;
+        Eigen::Array3i uv_indices;
+        // Line of the face in the file
+        long line;
+    };
+
+    /**
+     * Load the texture from a material library. Only the diffuse texture map (`map_Kd`) is supported.
+     */
+    void parse_material_library(const std::filesystem::path& mtl);
+
+    // Directory of the file being parsed
+    const std::filesystem::path directory;
+
+    Batch batch;
+    // Faces that refer to vertices or texture coordinates that have not been parsed yet
+    std::vector<PendingFace> pending_faces;
+    // Number of vertices in earlier batches
+    size_t num_taken_vertices = 0;
+    // Number of texture coordinates in earlier batches
+    size_t num_taken_uvs = 0;
+    // Number of lines parsed
+    long num_lines = 0;
+};
+
+}  // namespace raster::obj
@@ -1,5 +1,29 @@
 #include <raster/physics.hpp>
 
+#include <algorithm>
+
+#include <cassert>
+
+
+namespace
+{
+
+// Number of objects stepped together by `KineticsSystem`. Chunks are kept small enough to live on the stack.
+constexpr int CHUNK_SIZE = 64;
+
+// Array of values for a chunk of objects
+using Chunk = Eigen::Array<float, Eigen::Dynamic, 1, Eigen::ColMajor, CHUNK_SIZE, 1>;
+
+/**
+ * View of `n` contiguous values starting at `idx`.
+ */
+Eigen::Map<Eigen::ArrayXf> segment(std::vector<float>& values, size_t idx, int n)
+{
+    return Eigen::Map<Eigen::ArrayXf>(values.data() + idx, n);
+}
+
+}  // namespace
+
 
 namespace raster
 {
@@ -32,4 +56,99 @@ Eigen::Affine3f Kinetics::update(const Eigen::Vector3f& delta_pos_velocity, cons
     return pose;
 }
 
+size_t KineticsSystem::add(
+    float pos_friction,
+    float ang_friction,
+    const Eigen::Vector3f& init_pos_velocity,
+    const Eigen::Vector3f& init_ang_velocity)
+{
+    this->pos_friction.push_back(pos_friction);
+    this->ang_friction.push_back(ang_friction);
+    for (int i = 0; i < 3; ++i) {
+        pos_velocity[i].push_back(init_pos_velocity(i));
+        ang_velocity[i].push_back(init_ang_velocity(i));
+        delta_pos_velocity[i].push_back(0.f);
+        delta_ang_velocity[i].push_back(0.f);
+    }
+    return size() - 1;
+}
+
+void KineticsSystem::accelerate(
+    size_t idx, const Eigen::Vector3f& delta_pos_velocity, const Eigen::Vector3f& delta_ang_velocity)
+{
+    assert(idx < size());
+    for (int i = 0; i < 3; ++i) {
+        this->delta_pos_velocity[i][idx] += delta_pos_velocity(i);
+        this->delta_ang_velocity[i][idx] += delta_ang_velocity(i);
+    }
+}
+
+void KineticsSystem::update(
+    std::vector<Eigen::Quaternionf>& delta_rotations,
+    std::vector<Eigen::Vector3f>& delta_translations,
+    int num_threads)
+{
+    delta_rotations.resize(size());
+    delta_translations.resize(size());
+
+    // split objects into contiguous blocks, one per thread. the calling thread handles the first block
+    const size_t num_blocks = std::clamp<size_t>(num_threads, 1, std::max<size_t>(size() / CHUNK_SIZE, 1));
+    if (num_blocks == 1) {
+        update_range(0, size(), delta_rotations, delta_translations);
+        return;
+    }
+    const size_t block_size = (size() + num_blocks - 1) / num_blocks;
+
+    // the workers persist across steps. they are only restarted when the number of blocks changes
+    if (!workers || static_cast<size_t>(workers->size()) != num_blocks) {
+        workers = std::make_unique<ForkJoinPool>(num_blocks);
+    }
+    auto update_block = [&](int block) {
+        const size_t begin = std::min(block * block_size, size());
+        const size_t end = std::min(begin + block_size, size());
+        update_range(begin, end, delta_rotations, delta_translations);
+    };
+    workers->run(update_block);
+}
+
+void KineticsSystem::update_range(
+    size_t begin,
+    size_t end,
+    std::vector<Eigen::Quaternionf>& delta_rotations,
+    std::vector<Eigen::Vector3f>& delta_translations)
+{
+    for (size_t idx = begin; idx < end; idx += CHUNK_SIZE) {
+        const int n = std::min<size_t>(CHUNK_SIZE, end - idx);
+
+        // compute rotations as quaternions. the rotation angle is the norm of the angular velocity, so
+        // `(w, x, y, z) = (cos(angle / 2), sin(angle / 2) * axis)` where `axis = ang_velocity / angle`
+        const Chunk angle = (segment(ang_velocity[0], idx, n).square() + segment(ang_velocity[1], idx, n).square() +
+                             segment(ang_velocity[2], idx, n).square())
+                                .sqrt();
+        const Chunk half_angle = 0.5f * angle;
+        // NOTE: `sin(angle / 2) / angle` tends to 1/2 as the angle goes to zero
+        const Chunk scale = (angle > 0.f).select(half_angle.sin() / angle, 0.5f);
+        const Chunk w = half_angle.cos();
+        const Chunk x = scale * segment(ang_velocity[0], idx, n);
+        const Chunk y = scale * segment(ang_velocity[1], idx, n);
+        const Chunk z = scale * segment(ang_velocity[2], idx, n);
+
+        for (int j = 0; j < n; ++j) {
+            delta_rotations[idx + j] = Eigen::Quaternionf(w(j), x(j), y(j), z(j));
+            delta_translations[idx + j] = {
+                pos_velocity[0][idx + j], pos_velocity[1][idx + j], pos_velocity[2][idx + j]};
+        }
+
+        // update velocities
+        for (int i = 0; i < 3; ++i) {
+            segment(pos_velocity[i], idx, n) = segment(pos_friction, idx, n) * segment(pos_velocity[i], idx, n) +
+                                               segment(delta_pos_velocity[i], idx, n);
+            segment(ang_velocity[i], idx, n) = segment(ang_friction, idx, n) * segment(ang_velocity[i], idx, n) +
+                                               segment(delta_ang_velocity[i], idx, n);
+            segment(delta_pos_velocity[i], idx, n).setZero();
+            segment(delta_ang_velocity[i], idx, n).setZero();
+        }
+    }
+}
+
 }  // namespace raster
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <raster/pool.hpp>
+
 #include <Eigen/Dense>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 
 namespace raster
 {
@@ -27,9 +33,9 @@ public:
         const Eigen::Vector3f& init_ang_velocity = Eigen::Vector3f::Zero());
 
     /**
-     * Step forward one unit in time and return the update to the object's pose due to its positional and angular
-     * velocities. Can also be provided updates to the positional and angular velocities themselves, which will affect
-     * the object's motion in future steps.
+     * Step forward one unit in time (i.e. one physics tick) and return the update to the object's pose due to its
+     * positional and angular velocities. Can also be provided updates to the positional and angular velocities
+     * themselves, which will affect the object's motion in future steps.
      *
      * @param delta_pos_velocity Added to the object's velocity AFTER the pose correction is returned.
      * @param delta_ang_velocity Added to the object's angular velocity AFTER the pose correction is returned.
@@ -47,4 +53,94 @@ private:
     Eigen::Vector3f ang_velocity;
 };
 
+/**
+ * Representation of the motion of many physical objects. This is the batched analogue of `Kinetics`.
+ *
+ * Velocities are stored in struct-of-arrays form, i.e. one contiguous array per component, so that all objects can be
+ * stepped forward together in a single vectorized pass.
+ */
+class KineticsSystem
+{
+public:
+    KineticsSystem() = default;
+
+    // NOTE: copy constructors are deleted to prevent expensive copies
+    KineticsSystem(const KineticsSystem&) = delete;
+    KineticsSystem& operator=(const KineticsSystem&) = delete;
+
+    KineticsSystem(KineticsSystem&& other) = default;
+    KineticsSystem& operator=(KineticsSystem&& other) = default;
+
+    /**
+     * Add a new object.
+     *
+     * @param pos_friction Friction for positional velocity. 1.0 means no friction.
+     * @param ang_friction Friction for angular velocity. 1.0 means no friction.
+     * @param init_pos_velocity Initial positional velocity.
+     * @param init_ang_velocity Initial angular velocity.
+     * @returns Index of the new object.
+     */
+    size_t add(
+        float pos_friction = 1.f,
+        float ang_friction = 1.f,
+        const Eigen::Vector3f& init_pos_velocity = Eigen::Vector3f::Zero(),
+        const Eigen::Vector3f& init_ang_velocity = Eigen::Vector3f::Zero());
+
+    /**
+     * Update the positional and angular velocities of an object. This will affect the object's motion starting from
+     * the step AFTER the next call to `update()`, analogous to the arguments of `Kinetics::update()`.
+     *
+     * @param idx Index of the object.
+     * @param delta_pos_velocity Added to the object's velocity.
+     * @param delta_ang_velocity Added to the object's angular velocity.
+     */
+    void accelerate(size_t idx, const Eigen::Vector3f& delta_pos_velocity, const Eigen::Vector3f& delta_ang_velocity);
+
+    /**
+     * Step all objects forward one unit in time (i.e. one physics tick) and return the updates to their poses due to
+     * their positional and angular velocities.
+     *
+     * @param[out] delta_rotations Rotation part of the pose correction of each object. Resized to `size()`.
+     * @param[out] delta_translations Translation part of the pose correction of each object. Resized to `size()`.
+     * @param[in] num_threads Number of threads to split the objects over. The threads persist across steps.
+     */
+    void update(
+        std::vector<Eigen::Quaternionf>& delta_rotations,
+        std::vector<Eigen::Vector3f>& delta_translations,
+        int num_threads = 1);
+
+    /**
+     * Number of objects.
+     */
+    inline size_t size() const { return pos_friction.size(); }
+
+private:
+    /**
+     * A 3D vector per object, in struct-of-arrays form.
+     */
+    using Vectors = std::array<std::vector<float>, 3>;
+
+    /**
+     * Step forward the objects with indices in [begin, end).
+     */
+    void update_range(
+        size_t begin,
+        size_t end,
+        std::vector<Eigen::Quaternionf>& delta_rotations,
+        std::vector<Eigen::Vector3f>& delta_translations);
+
+    std::vector<float> pos_friction;
+    std::vector<float> ang_friction;
+
+    Vectors pos_velocity;
+    Vectors ang_velocity;
+
+    // Updates to the velocities, applied on the next step
+    Vectors delta_pos_velocity;
+    Vectors delta_ang_velocity;
+
+    // Threads that step the objects in parallel. Null until `update()` is called with more than one thread.
+    std::unique_ptr<ForkJoinPool> workers;
+};
+
 }  // namespace raster
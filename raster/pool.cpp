@@ -0,0 +1,138 @@
+#include <raster/pool.hpp>
+
+#include <cassert>
+
+
+namespace raster
+{
+
+ThreadPool::ThreadPool(int num_threads)
+{
+    assert(num_threads > 0);
+
+    for (int i = 0; i < num_threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    // NOTE: all queues must exist before any worker tries to steal from them
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this, i](std::stop_token stop_token) { work(stop_token, i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+    idle.notify_all();
+}
+
+void ThreadPool::submit(Task task)
+{
+    Queue& queue = *queues[next_queue++ % queues.size()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        // NOTE: updated under the lock so that a worker cannot miss the notification while it is going idle
+        std::lock_guard lock(idle_mutex);
+        ++num_pending;
+    }
+    idle.notify_one();
+}
+
+void ThreadPool::work(std::stop_token stop_token, int worker)
+{
+    Task task;
+    while (!stop_token.stop_requested()) {
+        if (take(worker, task)) {
+            task(worker);
+            continue;
+        }
+
+        std::unique_lock lock(idle_mutex);
+        idle.wait(lock, stop_token, [this]() { return num_pending > 0; });
+    }
+}
+
+bool ThreadPool::take(int worker, Task& task)
+{
+    // visit the worker's own queue first, then the others in order
+    for (size_t i = 0; i < queues.size(); ++i) {
+        Queue& queue = *queues[(worker + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        // run own tasks oldest first, so tasks finish roughly in the order they were submitted, but steal the newest
+        // tasks, which the other worker would have run last
+        if (i == 0) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        } else {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        --num_pending;
+        return true;
+    }
+    return false;
+}
+
+ForkJoinPool::ForkJoinPool(int num_parts)
+{
+    assert(num_parts > 0);
+
+    for (int part = 1; part < num_parts; ++part) {
+        threads.emplace_back([this, part](std::stop_token stop_token) { work(stop_token, part); });
+    }
+}
+
+ForkJoinPool::~ForkJoinPool()
+{
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+}
+
+void ForkJoinPool::run(Job job, void* context)
+{
+    // NOTE: the workers are all waiting for the next job, since the previous job has finished
+    this->job = job;
+    job_context = context;
+    num_finished.store(0, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    job(context, 0);
+
+    const int num_workers = threads.size();
+    int finished;
+    while ((finished = num_finished.load(std::memory_order_acquire)) < num_workers) {
+        num_finished.wait(finished, std::memory_order_acquire);
+    }
+}
+
+void ForkJoinPool::work(std::stop_token stop_token, int part)
+{
+    // NOTE: workers start before the first job, so no job has been missed
+    uint64_t seen = 0;
+    while (true) {
+        generation.wait(seen, std::memory_order_acquire);
+        if (stop_token.stop_requested()) {
+            return;
+        }
+        seen = generation.load(std::memory_order_acquire);
+
+        job(job_context, part);
+
+        num_finished.fetch_add(1, std::memory_order_release);
+        num_finished.notify_one();
+    }
+}
+
+}  // namespace raster
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * Pool of threads that run tasks, with work stealing.
+ *
+ * Each worker has its own queue of tasks. Tasks are spread over the queues as they are submitted. A worker runs the
+ * oldest task of its own queue first, and when its queue is empty, it steals the newest task of another worker's
+ * queue. Workers thus rarely contend for the same queue, no worker sits idle while tasks remain, and tasks roughly
+ * finish in the order they were submitted.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * A task. It is given the index of the worker that runs it, in [0, `size()`), e.g. to use per-worker buffers.
+     */
+    using Task = std::function<void(int worker)>;
+
+    /**
+     * Start the workers.
+     *
+     * @param num_threads Number of worker threads.
+     */
+    ThreadPool(int num_threads);
+
+    // NOTE: copy and move constructors are deleted since the workers refer to this object
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Stop the workers and wait for them to finish. Tasks that have not started are discarded.
+     */
+    ~ThreadPool();
+
+    /**
+     * Submit a task to be run by one of the workers.
+     */
+    void submit(Task task);
+
+    /**
+     * Number of worker threads.
+     */
+    inline int size() const { return queues.size(); }
+
+private:
+    /**
+     * Queue of tasks of a worker.
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * Run tasks until stopped. Runs on the worker threads.
+     */
+    void work(std::stop_token stop_token, int worker);
+
+    /**
+     * Take a task, preferably from the worker's own queue.
+     *
+     * @returns False if all queues are empty.
+     */
+    bool take(int worker, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    // Queue that the next task is submitted to
+    std::atomic<size_t> next_queue = 0;
+
+    // Number of tasks in all queues. Idle workers wait until it is positive.
+    std::atomic<long> num_pending = 0;
+    std::mutex idle_mutex;
+    std::condition_variable_any idle;
+
+    // NOTE: declared last so that the threads stop before the other members are destroyed
+    std::vector<std::jthread> threads;
+};
+
+/**
+ * Fixed group of threads that run one job at a time, for fork-join parallelism that repeats often, e.g. every tick.
+ *
+ * A job calls a function once for each of `size()` parts, in parallel, and returns once all calls have returned. The
+ * calling thread runs the first part itself. Unlike submitting tasks to a `ThreadPool`, running a job neither starts
+ * threads nor allocates memory.
+ */
+class ForkJoinPool
+{
+public:
+    /**
+     * Start the workers.
+     *
+     * @param num_parts Number of parts of each job. One less worker thread is started, since the calling thread runs
+     * the first part.
+     */
+    ForkJoinPool(int num_parts);
+
+    // NOTE: copy and move constructors are deleted since the workers refer to this object
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    /**
+     * Stop the workers and wait for them to finish.
+     */
+    ~ForkJoinPool();
+
+    /**
+     * Call `fn(part)` for each part in [0, `size()`), in parallel, and wait for all calls to return.
+     *
+     * @param fn Function to call. It is referred to rather than copied, so that running a job does not allocate.
+     */
+    template <typename Fn>
+    void run(Fn& fn)
+    {
+        run(&call<Fn>, &fn);
+    }
+
+    /**
+     * Number of parts of each job.
+     */
+    inline int size() const { return threads.size() + 1; }
+
+private:
+    /**
+     * Job, as a function that is given its context and the part to run.
+     */
+    using Job = void (*)(void* context, int part);
+
+    template <typename Fn>
+    static void call(void* fn, int part)
+    {
+        (*static_cast<Fn*>(fn))(part);
+    }
+
+    void run(Job job, void* context);
+
+    /**
+     * Run a part of each job until stopped. Runs on the worker threads.
+     */
+    void work(std::stop_token stop_token, int part);
+
+    // Current job. Written before `generation` is incremented.
+    Job job = nullptr;
+    void* job_context = nullptr;
+    // Incremented to start a job, or to wake the workers when stopping. Workers wait for it to change.
+    std::atomic<uint64_t> generation = 0;
+    // Number of workers that have finished the current job
+    std::atomic<int> num_finished = 0;
+
+    // NOTE: declared last so that the threads stop before the other members are destroyed
+    std::vector<std::jthread> threads;
+};
+
+}  // namespace raster
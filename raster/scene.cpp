@@ -0,0 +1,70 @@
+#include <raster/scene.hpp>
+
+#include <cassert>
+
+
+namespace raster
+{
+
+size_t Scene::add_mesh(Mesh&& mesh)
+{
+    meshes.push_back(std::move(mesh));
+    mesh_instances.emplace_back();
+    return meshes.size() - 1;
+}
+
+size_t Scene::add_instance(
+    size_t mesh,
+    const Eigen::Affine3f& pose,
+    float pos_friction,
+    float ang_friction,
+    const Eigen::Vector3f& init_pos_velocity,
+    const Eigen::Vector3f& init_ang_velocity)
+{
+    assert(mesh < meshes.size());
+
+    const size_t instance = kinetics.add(pos_friction, ang_friction, init_pos_velocity, init_ang_velocity);
+    assert(instance == rotations.size());
+
+    const Eigen::Quaternionf rotation(pose.linear());
+    rotations.push_back(rotation);
+    translations.push_back(pose.translation());
+    prev_rotations.push_back(rotation);
+    prev_translations.push_back(pose.translation());
+
+    mesh_instances[mesh].push_back(instance);
+
+    // size the buffers for pose updates now, so that `tick()` does not allocate
+    delta_rotations.resize(num_instances());
+    delta_translations.resize(num_instances());
+    return instance;
+}
+
+void Scene::accelerate(
+    size_t instance, const Eigen::Vector3f& delta_pos_velocity, const Eigen::Vector3f& delta_ang_velocity)
+{
+    kinetics.accelerate(instance, delta_pos_velocity, delta_ang_velocity);
+}
+
+void Scene::tick()
+{
+    kinetics.update(delta_rotations, delta_translations);
+
+    prev_rotations.swap(rotations);
+    prev_translations.swap(translations);
+    for (size_t i = 0; i < num_instances(); ++i) {
+        // left-multiply the pose by the pose correction
+        rotations[i] = (delta_rotations[i] * prev_rotations[i]).normalized();
+        translations[i] = delta_rotations[i] * prev_translations[i] + delta_translations[i];
+    }
+}
+
+Eigen::Affine3f Scene::pose(size_t instance, float alpha) const
+{
+    Eigen::Affine3f pose = Eigen::Affine3f::Identity();
+    pose.linear() = prev_rotations[instance].slerp(alpha, rotations[instance]).toRotationMatrix();
+    pose.translation() = (1 - alpha) * prev_translations[instance] + alpha * translations[instance];
+    return pose;
+}
+
+}  // namespace raster
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <raster/lighting.hpp>
+#include <raster/mesh.hpp>
+#include <raster/physics.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * A scene consists of mesh resources and instances of those meshes.
+ *
+ * Meshes are shared by all instances that reference them. Each instance only stores its own pose and kinetics, so
+ * memory use does not depend on the size of its mesh. Instances are grouped by mesh so that they can be rendered in
+ * batches.
+ */
+class Scene
+{
+public:
+    Scene() = default;
+
+    // NOTE: copy constructors are deleted to prevent expensive copies
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    Scene(Scene&& other) = default;
+    Scene& operator=(Scene&& other) = default;
+
+    /**
+     * Add a mesh resource to the scene.
+     *
+     * @param mesh The mesh.
+     * @returns Index of the mesh.
+     */
+    size_t add_mesh(Mesh&& mesh);
+
+    /**
+     * Add an instance of a mesh to the scene.
+     *
+     * @param mesh Index of the mesh.
+     * @param pose Initial pose of the instance, i.e. the transformation from mesh coordinates to world coordinates.
+     * @param pos_friction Friction for positional velocity. 1.0 means no friction.
+     * @param ang_friction Friction for angular velocity. 1.0 means no friction.
+     * @param init_pos_velocity Initial positional velocity.
+     * @param init_ang_velocity Initial angular velocity.
+     * @returns Index of the instance.
+     */
+    size_t add_instance(
+        size_t mesh,
+        const Eigen::Affine3f& pose,
+        float pos_friction = 1.f,
+        float ang_friction = 1.f,
+        const Eigen::Vector3f& init_pos_velocity = Eigen::Vector3f::Zero(),
+        const Eigen::Vector3f& init_ang_velocity = Eigen::Vector3f::Zero());
+
+    /**
+     * Update the positional and angular velocities of an instance. See `KineticsSystem::accelerate()`.
+     */
+    void accelerate(
+        size_t instance, const Eigen::Vector3f& delta_pos_velocity, const Eigen::Vector3f& delta_ang_velocity);
+
+    /**
+     * Step all instances forward one unit in time (i.e. one physics tick).
+     */
+    void tick();
+
+    /**
+     * Get the pose of an instance.
+     *
+     * @param instance Index of the instance.
+     * @param alpha Interpolation parameter in [0, 1] between the poses at the previous and current physics ticks.
+     */
+    Eigen::Affine3f pose(size_t instance, float alpha = 1.f) const;
+
+    inline const Mesh& mesh(size_t idx) const { return meshes[idx]; }
+
+    /**
+     * Mutable access to a mesh, e.g. to extend it while it is being loaded. Changes affect all of its instances.
+     */
+    inline Mesh& mesh(size_t idx) { return meshes[idx]; }
+
+    /**
+     * Indices of the instances of the given mesh.
+     */
+    inline const std::vector<size_t>& instances(size_t mesh) const { return mesh_instances[mesh]; }
+
+    inline const Lighting& lighting() const { return _lighting; }
+
+    inline Lighting& lighting() { return _lighting; }
+
+    inline size_t num_meshes() const { return meshes.size(); }
+
+    inline size_t num_instances() const { return rotations.size(); }
+
+private:
+    std::vector<Mesh> meshes;
+    // Indices of the instances of each mesh
+    std::vector<std::vector<size_t>> mesh_instances;
+
+    // Pose of each instance at the current physics tick, as a rotation followed by a translation
+    std::vector<Eigen::Quaternionf> rotations;
+    std::vector<Eigen::Vector3f> translations;
+    // Pose of each instance at the previous physics tick
+    std::vector<Eigen::Quaternionf> prev_rotations;
+    std::vector<Eigen::Vector3f> prev_translations;
+
+    KineticsSystem kinetics;
+
+    Lighting _lighting;
+
+    // Buffers for pose updates, reused across ticks
+    std::vector<Eigen::Quaternionf> delta_rotations;
+    std::vector<Eigen::Vector3f> delta_translations;
+};
+
+}  // namespace raster
@@ -0,0 +1,41 @@
+#include <raster/shading.hpp>
+
+
+namespace raster::shading
+{
+
+Textured::Textured(
+    const FrameArena& frame, const VertexArena&, const Mesh& mesh, size_t face, const Eigen::Vector3f& z)
+    : texture(&mesh.texture())
+{
+    const Eigen::Array3i& indices = mesh.face_vertex_indices()[face];
+    const Eigen::Array3i& uv_indices = mesh.face_uv_indices()[face];
+
+    // texture coordinates of the vertices. missing coordinates default to zero
+    Eigen::Vector2f uv[3];
+    for (int i = 0; i < 3; ++i) {
+        uv[i] = uv_indices(i) >= 0 ? mesh.uvs()[uv_indices(i)] : Eigen::Vector2f::Zero();
+    }
+    corrected_uv1 = uv[0] / z(0);
+    corrected_uv2 = uv[1] / z(1);
+    corrected_uv3 = uv[2] / z(2);
+
+    // barycentric coordinates are linear in screen position. compute their derivatives from the edge functions
+    const Eigen::Vector2f& p1 = frame.pixel_vertices[indices(0)];
+    const Eigen::Vector2f& p2 = frame.pixel_vertices[indices(1)];
+    const Eigen::Vector2f& p3 = frame.pixel_vertices[indices(2)];
+    const float signed_area = (p1.x() - p2.x()) * (p3.y() - p2.y()) - (p1.y() - p2.y()) * (p3.x() - p2.x());
+    const float inv_area = signed_area != 0 ? 1 / signed_area : 0;
+
+    const Eigen::Vector3f db_dx = inv_area * Eigen::Vector3f(p3.y() - p2.y(), p1.y() - p3.y(), p2.y() - p1.y());
+    const Eigen::Vector3f db_dy = inv_area * Eigen::Vector3f(p2.x() - p3.x(), p3.x() - p1.x(), p1.x() - p2.x());
+
+    duv_dx_corrected = db_dx(0) * corrected_uv1 + db_dx(1) * corrected_uv2 + db_dx(2) * corrected_uv3;
+    duv_dy_corrected = db_dy(0) * corrected_uv1 + db_dy(1) * corrected_uv2 + db_dy(2) * corrected_uv3;
+
+    const Eigen::Vector3f inv_z = z.cwiseInverse();
+    dinv_z_dx = db_dx.dot(inv_z);
+    dinv_z_dy = db_dy.dot(inv_z);
+}
+
+}  // namespace raster::shading
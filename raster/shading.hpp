@@ -0,0 +1,139 @@
+#pragma once
+
+#include <raster/colors.hpp>
+#include <raster/frame.hpp>
+#include <raster/mesh.hpp>
+
+#include <Eigen/Dense>
+
+
+namespace raster
+{
+
+/**
+ * Shading modes.
+ *
+ * Each mode is implemented by a shader in `raster::shading`. The rasterizer is instantiated once per shader and the
+ * shader is chosen once per draw, so the per-pixel loop never branches on the mode and unused features cost nothing.
+ */
+enum class Shading {
+    // Only depth is written. Colors are derived from depth afterwards.
+    Depth,
+    // Each face has a single color, the average of its vertex colors.
+    Flat,
+    // Vertex colors are interpolated across each face.
+    Gouraud,
+    // Vertex colors are lit by the scene's lights, then interpolated across each face.
+    Lit,
+    // Colors are sampled from the mesh's texture. Meshes without a texture fall back to `Gouraud`.
+    Textured,
+};
+
+namespace shading
+{
+
+/**
+ * A shader is constructed once per face and then called once per pixel. It must provide:
+ * - `static constexpr bool writes_color`: whether the shader produces colors at all.
+ * - A constructor `Shader(const FrameArena& frame, const VertexArena& vertices, const Mesh& mesh, size_t face,
+ *   const Eigen::Vector3f& z)`, where `face` is the index of the face in `mesh` and `z` holds the z-coordinates of its
+ *   vertices in camera space. The vertex buffers of `frame` and `vertices` are filled in for `mesh`.
+ * - `Eigen::Array3f operator()(float b1, float b2, float b3, float z) const`, which returns the sRGB color of a pixel
+ *   given its barycentric coordinates and its z-coordinate in camera space.
+ */
+
+/**
+ * Shader that does not produce colors, for depth-only passes.
+ */
+struct Depth {
+    static constexpr bool writes_color = false;
+
+    Depth(const FrameArena&, const VertexArena&, const Mesh&, size_t, const Eigen::Vector3f&) {}
+
+    Eigen::Array3f operator()(float, float, float, float) const { return Eigen::Array3f::Zero(); }
+};
+
+/**
+ * Shader that colors each face uniformly.
+ */
+struct Flat {
+    static constexpr bool writes_color = true;
+
+    Flat(const FrameArena&, const VertexArena& vertices, const Mesh& mesh, size_t face, const Eigen::Vector3f&)
+    {
+        const Eigen::Array3i& indices = mesh.face_vertex_indices()[face];
+        const auto& colors = vertices.linear_colors;
+        color = linear_to_srgb((colors[indices(0)] + colors[indices(1)] + colors[indices(2)]) / 3);
+    }
+
+    Eigen::Array3f operator()(float, float, float, float) const { return color; }
+
+    // Color of the face, in sRGB color space
+    Eigen::Array3f color;
+};
+
+/**
+ * Shader that interpolates vertex colors using perspective-correct interpolation.
+ */
+struct Gouraud {
+    static constexpr bool writes_color = true;
+
+    Gouraud(const FrameArena&, const VertexArena& vertices, const Mesh& mesh, size_t face, const Eigen::Vector3f& z)
+    {
+        const Eigen::Array3i& indices = mesh.face_vertex_indices()[face];
+        corrected_c1 = vertices.linear_colors[indices(0)] / z(0);
+        corrected_c2 = vertices.linear_colors[indices(1)] / z(1);
+        corrected_c3 = vertices.linear_colors[indices(2)] / z(2);
+    }
+
+    Eigen::Array3f operator()(float b1, float b2, float b3, float z) const
+    {
+        return linear_to_srgb(z * (corrected_c1 * b1 + corrected_c2 * b2 + corrected_c3 * b3));
+    }
+
+    // Vertex colors in linear color space, divided by z-coordinate
+    Eigen::Array3f corrected_c1;
+    Eigen::Array3f corrected_c2;
+    Eigen::Array3f corrected_c3;
+};
+
+/**
+ * Shader that samples the mesh's texture using perspective-correct texture coordinates. The mipmap level is chosen
+ * from the screen-space derivatives of the texture coordinates.
+ */
+struct Textured {
+    static constexpr bool writes_color = true;
+
+    Textured(const FrameArena& frame, const VertexArena&, const Mesh& mesh, size_t face, const Eigen::Vector3f& z);
+
+    Eigen::Array3f operator()(float b1, float b2, float b3, float z) const
+    {
+        // perspective-correct texture coordinates, i.e. `uv = z * (b1 * uv1 / z1 + b2 * uv2 / z2 + b3 * uv3 / z3)`
+        const Eigen::Vector2f uv = z * (b1 * corrected_uv1 + b2 * corrected_uv2 + b3 * corrected_uv3);
+
+        // by the quotient rule, the derivative of `uv` with respect to screen position is `z * (d(uv / z) - uv *
+        // d(1 / z))`, where `uv / z` and `1 / z` are linear in screen position
+        const Eigen::Vector2f duv_dx = z * (duv_dx_corrected - uv * dinv_z_dx);
+        const Eigen::Vector2f duv_dy = z * (duv_dy_corrected - uv * dinv_z_dy);
+        const float footprint = std::sqrt(std::max(duv_dx.squaredNorm(), duv_dy.squaredNorm()));
+
+        return texture->sample(uv, footprint);
+    }
+
+    const Texture* texture;
+
+    // Texture coordinates of the vertices, divided by z-coordinate
+    Eigen::Vector2f corrected_uv1;
+    Eigen::Vector2f corrected_uv2;
+    Eigen::Vector2f corrected_uv3;
+
+    // Derivatives of `uv / z` and `1 / z` with respect to the screen-space column (x) and row (y)
+    Eigen::Vector2f duv_dx_corrected;
+    Eigen::Vector2f duv_dy_corrected;
+    float dinv_z_dx;
+    float dinv_z_dy;
+};
+
+}  // namespace shading
+
+}  // namespace raster
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * Layout of the shared memory that frames are exported to. See `FrameExporter`.
+ *
+ * The shared memory starts with a `Header`, followed by `NUM_SLOTS` slots that form a ring buffer of frames. Each slot
+ * holds the color pairs of a frame, as `uint8_t` in row-major order, followed by its packed depths, as `uint16_t` in
+ * row-major order. A packed depth of zero means that nothing was drawn; otherwise, the z-coordinate of the pixel in
+ * camera space is `depth_scale / depth`. The buffers of a slot are sized for the largest frame, i.e.
+ * `max_height * max_width` pixels, and padded to a multiple of 8 bytes.
+ *
+ * Each slot is guarded by a sequence lock. The writer makes the sequence number odd before writing a frame to the slot
+ * and even again afterwards. A reader reads the sequence number, reads the frame in place, and then reads the sequence
+ * number again. The frame is consistent if both sequence numbers are equal and even; otherwise, the writer overwrote
+ * the slot in the meantime. The writer never waits for readers.
+ *
+ * This header only depends on the standard library, so that other programs can include it.
+ */
+namespace raster::shm
+{
+
+// Identifies the shared memory as a frame buffer export
+constexpr uint32_t MAGIC = 0x52535452;  // "RSTR"
+// Version of the layout. Incremented when the layout changes.
+constexpr uint32_t VERSION = 2;
+// Number of slots of the ring buffer
+constexpr uint32_t NUM_SLOTS = 4;
+
+// NOTE: atomics in shared memory must not rely on locks, which would be local to each process
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+/**
+ * Header of a slot.
+ */
+struct Slot {
+    // Sequence number. Odd while the slot is being written.
+    std::atomic<uint64_t> sequence;
+    // Index of the frame in the slot, counting from zero
+    uint64_t frame;
+    // Size of the frame in the slot, in pixels
+    int32_t height;
+    int32_t width;
+};
+
+/**
+ * Header of the shared memory.
+ */
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    // Size of the largest frame that fits in a slot, in pixels
+    int32_t max_height;
+    int32_t max_width;
+    // Scale of the packed depths
+    float depth_scale;
+    // Number of frames that have been published. The latest frame is in slot `(num_frames - 1) % NUM_SLOTS`.
+    std::atomic<uint64_t> num_frames;
+    Slot slots[NUM_SLOTS];
+};
+
+/**
+ * Round a size in bytes up to a multiple of 8, so that the buffers that follow stay aligned.
+ */
+inline size_t padded(size_t bytes)
+{
+    return (bytes + 7) / 8 * 8;
+}
+
+/**
+ * Size in bytes of a slot's buffer of color pairs.
+ */
+inline size_t color_pairs_size(int max_height, int max_width)
+{
+    return padded(static_cast<size_t>(max_height) * max_width * sizeof(uint8_t));
+}
+
+/**
+ * Size in bytes of a slot's buffer of depths.
+ */
+inline size_t depth_size(int max_height, int max_width)
+{
+    return padded(static_cast<size_t>(max_height) * max_width * sizeof(uint16_t));
+}
+
+/**
+ * Size in bytes of the shared memory.
+ */
+inline size_t size(int max_height, int max_width)
+{
+    return sizeof(Header) + NUM_SLOTS * (color_pairs_size(max_height, max_width) + depth_size(max_height, max_width));
+}
+
+/**
+ * Color pairs of the frame in a slot.
+ */
+inline uint8_t* color_pairs(Header* header, uint32_t slot)
+{
+    const size_t slot_size = color_pairs_size(header->max_height, header->max_width) +
+                             depth_size(header->max_height, header->max_width);
+    return reinterpret_cast<uint8_t*>(reinterpret_cast<std::byte*>(header + 1) + slot * slot_size);
+}
+
+inline const uint8_t* color_pairs(const Header* header, uint32_t slot)
+{
+    return color_pairs(const_cast<Header*>(header), slot);
+}
+
+/**
+ * Depths of the frame in a slot.
+ */
+inline uint16_t* depth(Header* header, uint32_t slot)
+{
+    std::byte* pairs = reinterpret_cast<std::byte*>(color_pairs(header, slot));
+    return reinterpret_cast<uint16_t*>(pairs + color_pairs_size(header->max_height, header->max_width));
+}
+
+inline const uint16_t* depth(const Header* header, uint32_t slot)
+{
+    return depth(const_cast<Header*>(header), slot);
+}
+
+}  // namespace raster::shm
@@ -0,0 +1,217 @@
+#include <raster/texture.hpp>
+
+#include <raster/colors.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include <cassert>
+#include <cmath>
+
+
+namespace
+{
+
+/**
+ * Smallest exponent `n` such that `2^n >= x`.
+ */
+int ceil_log2(int x)
+{
+    int n = 0;
+    while ((1 << n) < x) {
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * Wrap a texture coordinate to [0, 1]. Non-finite coordinates, e.g. from degenerate faces, are mapped to zero.
+ */
+float wrap(float t)
+{
+    return std::isfinite(t) ? t - std::floor(t) : 0.f;
+}
+
+/**
+ * Spread the lower 16 bits of `x` so that there is a zero bit between each of them.
+ */
+uint32_t part_1_by_1(uint32_t x)
+{
+    x &= 0x0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+/**
+ * Read the next integer of a .ppm header, skipping comments. Returns -1 on failure.
+ */
+int read_header_value(std::istream& f)
+{
+    f >> std::ws;
+    while (f.peek() == '#') {
+        f.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        f >> std::ws;
+    }
+    int value = -1;
+    f >> value;
+    return f ? value : -1;
+}
+
+}  // namespace
+
+
+namespace raster
+{
+
+Texture::Texture(int width, int height, const std::vector<Eigen::Array3f>& pixels)
+{
+    assert(width > 0 && height > 0);
+    assert(pixels.size() == static_cast<size_t>(width * height));
+
+    // resample to power-of-two dimensions using nearest neighbors. texels are kept in linear color space while the
+    // mipmaps are computed
+    const int log2_width = ceil_log2(width);
+    const int log2_height = ceil_log2(height);
+    int level_width = 1 << log2_width;
+    int level_height = 1 << log2_height;
+
+    std::vector<Eigen::Array3f> linear(level_width * level_height);
+    for (int y = 0; y < level_height; ++y) {
+        for (int x = 0; x < level_width; ++x) {
+            const int src_x = x * width / level_width;
+            const int src_y = y * height / level_height;
+            linear[y * level_width + x] = srgb_to_linear(pixels[src_y * width + src_x]);
+        }
+    }
+
+    for (int level = 0;; ++level) {
+        // store level in Morton order
+        Level& l = levels.emplace_back(Level{
+            .log2_width = std::max(log2_width - level, 0),
+            .log2_height = std::max(log2_height - level, 0),
+            .texels = std::vector<Texel>(level_width * level_height)});
+        for (int y = 0; y < level_height; ++y) {
+            for (int x = 0; x < level_width; ++x) {
+                const Eigen::Array3f c = linear_to_srgb(linear[y * level_width + x]).max(0.f).min(1.f);
+                l.texels[morton_index(x, y, l.log2_width, l.log2_height)] = {
+                    static_cast<uint8_t>(std::lround(c(0) * 255)),
+                    static_cast<uint8_t>(std::lround(c(1) * 255)),
+                    static_cast<uint8_t>(std::lround(c(2) * 255)),
+                    0};
+            }
+        }
+
+        if (level_width == 1 && level_height == 1) {
+            break;
+        }
+
+        // downsample with a box filter
+        const int next_width = std::max(level_width / 2, 1);
+        const int next_height = std::max(level_height / 2, 1);
+        std::vector<Eigen::Array3f> next(next_width * next_height);
+        for (int y = 0; y < next_height; ++y) {
+            for (int x = 0; x < next_width; ++x) {
+                const int x0 = x * level_width / next_width;
+                const int y0 = y * level_height / next_height;
+                const int x1 = std::min(x0 + 1, level_width - 1);
+                const int y1 = std::min(y0 + 1, level_height - 1);
+                next[y * next_width + x] = (linear[y0 * level_width + x0] + linear[y0 * level_width + x1] +
+                                            linear[y1 * level_width + x0] + linear[y1 * level_width + x1]) /
+                                           4;
+            }
+        }
+        linear = std::move(next);
+        level_width = next_width;
+        level_height = next_height;
+    }
+}
+
+Texture::Texture(const char* ppm)
+{
+    // NOTE: if the file cannot be read, the texture is left empty
+    std::ifstream f(ppm, std::ios::binary);
+    std::string magic;
+    f >> magic;
+    if (magic != "P3" && magic != "P6") {
+        return;
+    }
+    const int width = read_header_value(f);
+    const int height = read_header_value(f);
+    const int max_value = read_header_value(f);
+    if (width <= 0 || height <= 0 || max_value <= 0) {
+        return;
+    }
+
+    std::vector<Eigen::Array3f> pixels(width * height);
+    if (magic == "P3") {
+        for (auto& pixel : pixels) {
+            int r, g, b;
+            f >> r >> g >> b;
+            pixel = Eigen::Array3f(r, g, b) / max_value;
+        }
+    } else {
+        // a single whitespace character separates the header from the binary data
+        f.get();
+        const int bytes_per_value = max_value < 256 ? 1 : 2;
+        for (auto& pixel : pixels) {
+            for (int i = 0; i < 3; ++i) {
+                int value = 0;
+                for (int byte = 0; byte < bytes_per_value; ++byte) {
+                    value = (value << 8) | static_cast<uint8_t>(f.get());
+                }
+                pixel(i) = static_cast<float>(value) / max_value;
+            }
+        }
+    }
+    if (!f) {
+        return;
+    }
+
+    *this = Texture(width, height, pixels);
+}
+
+Eigen::Array3f Texture::sample(const Eigen::Vector2f& uv, float footprint) const
+{
+    assert(!empty());
+
+    // choose the level where one texel covers about one pixel. the footprint is measured in texels of the full
+    // resolution level, so each level halves it
+    const Level& base = levels.front();
+    const float texels = footprint * (1 << std::max(base.log2_width, base.log2_height));
+    int level = 0;
+    if (!std::isfinite(texels)) {
+        // NaN if the footprint is degenerate. use the coarsest level, which is correct for an infinite footprint
+        level = levels.size() - 1;
+    } else if (texels > 1.f) {
+        std::frexp(texels, &level);
+        level = std::min<int>(level - 1, levels.size() - 1);
+    }
+    const Level& l = levels[level];
+
+    // wrap texture coordinates before converting them to texels, so that the conversion is in range. the masks catch
+    // coordinates that round up to 1. NOTE: rows are stored top to bottom, but v points up
+    const uint32_t width_mask = (1u << l.log2_width) - 1;
+    const uint32_t height_mask = (1u << l.log2_height) - 1;
+    const uint32_t x = static_cast<uint32_t>(wrap(uv.x()) * (width_mask + 1)) & width_mask;
+    const uint32_t y = static_cast<uint32_t>(wrap(1 - uv.y()) * (height_mask + 1)) & height_mask;
+
+    const Texel& texel = l.texels[morton_index(x, y, l.log2_width, l.log2_height)];
+    return Eigen::Array3f(texel[0], texel[1], texel[2]) / 255;
+}
+
+size_t Texture::morton_index(uint32_t x, uint32_t y, int log2_width, int log2_height)
+{
+    const int shared_bits = std::min(log2_width, log2_height);
+    const uint32_t shared_mask = (1u << shared_bits) - 1;
+    const size_t low = part_1_by_1(x & shared_mask) | (part_1_by_1(y & shared_mask) << 1);
+    // at most one of these is non-zero
+    const size_t high = (x >> shared_bits) | (y >> shared_bits);
+    return low | (high << (2 * shared_bits));
+}
+
+}  // namespace raster
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+
+namespace raster
+{
+
+/**
+ * Texture image with a chain of mipmaps.
+ *
+ * Each mipmap level stores its texels in Morton (Z-order) layout, so that texels that are close in the image are also
+ * close in memory. Sampling picks the mipmap level whose texels are about the size of a pixel, which keeps texture
+ * fetches for neighboring pixels in cache.
+ */
+class Texture
+{
+public:
+    Texture() = default;
+
+    /**
+     * Create a texture from an image. The image is resampled to have power-of-two dimensions.
+     *
+     * @param width Image width, in pixels.
+     * @param height Image height, in pixels.
+     * @param pixels Row-major pixels, as sRGB values normalized to [0, 1].
+     */
+    Texture(int width, int height, const std::vector<Eigen::Array3f>& pixels);
+
+    /**
+     * Load texture from a .ppm file (either ASCII "P3" or binary "P6"). The texture is empty if the file cannot be
+     * read.
+     *
+     * @param ppm Path to file.
+     */
+    Texture(const char* ppm);
+
+    // NOTE: copy constructors are deleted to prevent expensive copies
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    Texture(Texture&& other) = default;
+    Texture& operator=(Texture&& other) = default;
+
+    /**
+     * Sample the texture with nearest-texel lookup and nearest-mipmap selection. Texture coordinates wrap around.
+     *
+     * @param uv Texture coordinates, where (0, 0) is the bottom-left of the image and (1, 1) is the top-right.
+     * @param footprint Size of the pixel being shaded in texture coordinates, i.e. the length of the derivative of
+     * `uv` with respect to screen-space position.
+     * @returns Color as sRGB value normalized to [0, 1].
+     */
+    Eigen::Array3f sample(const Eigen::Vector2f& uv, float footprint) const;
+
+    /**
+     * Returns true if the texture has no texels.
+     */
+    inline bool empty() const { return levels.empty(); }
+
+private:
+    /**
+     * Texel as 8-bit sRGB values. Padded to 4 bytes so that texels are aligned.
+     */
+    using Texel = std::array<uint8_t, 4>;
+
+    /**
+     * A mipmap level.
+     */
+    struct Level {
+        // Base-2 logarithm of the width.
+        int log2_width;
+        // Base-2 logarithm of the height.
+        int log2_height;
+        // Texels in Morton order. See `morton_index()`.
+        std::vector<Texel> texels;
+    };
+
+    /**
+     * Index of the texel at column `x` and row `y` in a level stored in Morton order. The bits of `x` and `y` are
+     * interleaved; for non-square levels, the remaining high bits of the longer side are appended.
+     */
+    static size_t morton_index(uint32_t x, uint32_t y, int log2_width, int log2_height);
+
+    // Mipmap levels, from full resolution to 1x1
+    std::vector<Level> levels;
+};
+
+}  // namespace raster
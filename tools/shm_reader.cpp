@@ -0,0 +1,175 @@
+#include <raster/shm.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <thread>
+
+
+namespace
+{
+
+// Time without new frames after which the reader assumes that the writer has quit
+constexpr std::chrono::seconds IDLE_TIMEOUT(2);
+// Time between checks for new frames
+constexpr std::chrono::milliseconds POLL_INTERVAL(1);
+
+/**
+ * Summary of a frame.
+ */
+struct Summary {
+    uint64_t frame;
+    int height;
+    int width;
+    // Number of pixels that have been drawn
+    long num_drawn;
+    float min_depth;
+    float max_depth;
+};
+
+/**
+ * Summarize the frame in a slot, reading it in place.
+ *
+ * @param[in] header Header of the shared memory.
+ * @param[in] slot_index Index of the slot.
+ * @param[out] summary Summary of the frame.
+ * @returns False if the frame was overwritten while it was read, in which case `summary` is invalid.
+ */
+bool summarize(const raster::shm::Header* header, uint32_t slot_index, Summary& summary)
+{
+    const raster::shm::Slot& slot = header->slots[slot_index];
+
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0) {
+        return false;
+    }
+
+    summary = {
+        .frame = slot.frame,
+        .height = std::min(slot.height, header->max_height),
+        .width = std::min(slot.width, header->max_width),
+        .num_drawn = 0,
+        .min_depth = std::numeric_limits<float>::max(),
+        .max_depth = 0.f,
+    };
+    const uint8_t* color_pairs = raster::shm::color_pairs(header, slot_index);
+    const uint16_t* depth = raster::shm::depth(header, slot_index);
+    for (long i = 0; i < static_cast<long>(summary.height) * summary.width; ++i) {
+        if (color_pairs[i] != 0 || depth[i] != 0) {
+            ++summary.num_drawn;
+        }
+        if (depth[i] != 0) {
+            const float z = header->depth_scale / depth[i];
+            summary.min_depth = std::min(summary.min_depth, z);
+            summary.max_depth = std::max(summary.max_depth, z);
+        }
+    }
+
+    // the fence keeps the reads above from being reordered after the check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+}  // namespace
+
+
+/**
+ * Reads frames exported by `main --export-shm NAME` and prints a summary of each frame. This doubles as an example
+ * of how to read the shared memory; see `raster/shm.hpp` for the layout.
+ */
+int main(int argc, char** argv)
+{
+    // parse arguments
+    const char* name = nullptr;
+    long max_frames = -1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), max_frames);
+            if (error != std::errc() || end != value.data() + value.size()) {
+                name = nullptr;
+                break;
+            }
+        } else if (!name && !arg.starts_with("--")) {
+            name = argv[i];
+        } else {
+            name = nullptr;
+            break;
+        }
+    }
+    if (!name) {
+        std::cerr << "usage: " << argv[0] << " NAME [--frames NUM_FRAMES]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // map shared memory
+    const int fd = shm_open(name, O_RDONLY, 0);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(raster::shm::Header)) {
+        std::cerr << "cannot open shared memory " << name << std::endl;
+        return EXIT_FAILURE;
+    }
+    void* memory = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "cannot map shared memory " << name << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto* header = static_cast<const raster::shm::Header*>(memory);
+    if (header->magic != raster::shm::MAGIC || header->version != raster::shm::VERSION ||
+        static_cast<size_t>(st.st_size) < raster::shm::size(header->max_height, header->max_width)) {
+        std::cerr << "shared memory " << name << " does not hold exported frames" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // read frames as they are published
+    long num_read = 0;
+    long num_missed = 0;
+    uint64_t next_frame = header->num_frames.load(std::memory_order_acquire);
+    auto t_last_frame = std::chrono::steady_clock::now();
+    while (max_frames < 0 || num_read < max_frames) {
+        const uint64_t num_frames = header->num_frames.load(std::memory_order_acquire);
+        if (num_frames <= next_frame) {
+            if (std::chrono::steady_clock::now() - t_last_frame > IDLE_TIMEOUT) {
+                break;
+            }
+            std::this_thread::sleep_for(POLL_INTERVAL);
+            continue;
+        }
+
+        // skip to the latest frame if the reader fell behind
+        const uint64_t frame = num_frames - 1;
+        num_missed += frame - next_frame;
+        next_frame = num_frames;
+        t_last_frame = std::chrono::steady_clock::now();
+
+        Summary summary;
+        if (!summarize(header, frame % raster::shm::NUM_SLOTS, summary) || summary.frame != frame) {
+            ++num_missed;
+            continue;
+        }
+        ++num_read;
+
+        std::cout << "frame " << summary.frame << ": " << summary.width << "x" << summary.height << ", "
+                  << summary.num_drawn << " pixels drawn";
+        if (summary.max_depth > 0) {
+            std::cout << ", depth " << summary.min_depth << " to " << summary.max_depth;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "frames read: " << num_read << ", missed: " << num_missed << std::endl;
+
+    munmap(memory, st.st_size);
+    return EXIT_SUCCESS;
+}